@@ -0,0 +1,146 @@
+#include "Animation.h"
+#include <fstream>
+#include <sstream>
+
+AnimClip AnimationLibrary::clips[ANIM_CLIP_COUNT];
+
+const char* const AnimationLibrary::clipNames[ANIM_CLIP_COUNT] = {
+    "player_idle",
+    "player_run",
+    "player_jump",
+    "player_fall",
+    "apple",
+    "block_idle",
+    "block_hit",
+    "block_part_1",
+    "block_part_2",
+    "saw",
+    "spiked_ball",
+    "spiked_ball_chain",
+    "spike_head",
+    "spikes",
+    "fan",
+    "melon",
+    "pineapple"
+};
+
+bool AnimationLibrary::load(const std::string& path, SDL_Renderer* renderer) {
+    std::ifstream inFile(path);
+    if (!inFile.is_open()) {
+        printf("Failed to open animation data: %s\n", path.c_str());
+        return false;
+    }
+
+    bool loaded[ANIM_CLIP_COUNT] = {};
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(inFile, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        std::istringstream ss(line);
+        std::string name;
+        int frames = 0, frameW = 0, frameH = 0, frameMs = 0;
+        std::string categoryName;
+        std::string sheet;
+        ss >> name >> frames >> frameW >> frameH >> frameMs >> categoryName;
+        std::getline(ss >> std::ws, sheet);
+        if (sheet.empty()) {
+            printf("%s:%d: malformed clip definition\n", path.c_str(), lineNumber);
+            continue;
+        }
+        while (!sheet.empty() && (sheet.back() == ' ' || sheet.back() == '\t')) sheet.pop_back();
+
+        int id = -1;
+        for (int i = 0; i < ANIM_CLIP_COUNT; ++i) {
+            if (name == clipNames[i]) { id = i; break; }
+        }
+        if (id < 0) {
+            printf("%s:%d: unknown clip '%s'\n", path.c_str(), lineNumber, name.c_str());
+            continue;
+        }
+        if (frames <= 0 || frameW <= 0 || frameH <= 0 || frameMs <= 0) {
+            printf("%s:%d: invalid frame data for clip '%s'\n", path.c_str(), lineNumber, name.c_str());
+            continue;
+        }
+
+        int category = -1;
+        for (int c = 0; c < TEXTURE_CATEGORY_COUNT; ++c) {
+            if (categoryName == TextureManager::getCategoryName(static_cast<TextureCategory>(c))) {
+                category = c;
+                break;
+            }
+        }
+        if (category < 0) {
+            printf("%s:%d: unknown texture category '%s' for clip '%s'\n", path.c_str(), lineNumber,
+                   categoryName.c_str(), name.c_str());
+            continue;
+        }
+
+        AssetId asset = findAsset(sheet.c_str());
+        if (asset == INVALID_ASSET) {
+            printf("%s:%d: sheet '%s' is not in the asset manifest\n", path.c_str(), lineNumber, sheet.c_str());
+            continue;
+        }
+        const AssetInfo& info = ASSET_MANIFEST[asset];
+        if (frameW * frames > info.width || frameH > info.height) {
+            printf("%s:%d: %d frame(s) of %dx%d do not fit in %s (%dx%d)\n", path.c_str(), lineNumber,
+                   frames, frameW, frameH, info.path, info.width, info.height);
+            continue;
+        }
+
+        AnimClip& clip = clips[id];
+        TextureManager::release(clip.texture);
+        clip.texture = TextureManager::acquire(asset, renderer, static_cast<TextureCategory>(category));
+        clip.frames = static_cast<Uint16>(frames);
+        clip.frameW = static_cast<Uint16>(frameW);
+        clip.frameH = static_cast<Uint16>(frameH);
+        clip.frameMs = static_cast<Uint16>(frameMs);
+        loaded[id] = true;
+    }
+
+    bool complete = true;
+    for (int i = 0; i < ANIM_CLIP_COUNT; ++i) {
+        if (!loaded[i]) {
+            printf("Warning: animation clip '%s' missing from %s\n", clipNames[i], path.c_str());
+            complete = false;
+        }
+    }
+    printf("Animation clips loaded from %s\n", path.c_str());
+    return complete;
+}
+
+void AnimationLibrary::unload() {
+    for (int i = 0; i < ANIM_CLIP_COUNT; ++i) {
+        TextureManager::release(clips[i].texture);
+    }
+}
+
+void AnimationLibrary::play(AnimState& state, AnimClipId clip) {
+    if (state.clip == clip) return;
+    state.clip = clip;
+    state.frame = 0;
+    state.elapsedMs = 0;
+}
+
+void AnimationLibrary::advance(AnimState& state, Uint32 dtMs) {
+    const AnimClip& clip = clips[state.clip];
+    if (clip.frames <= 1) {
+        state.frame = 0;
+        return;
+    }
+    state.elapsedMs += dtMs;
+    if (state.elapsedMs >= clip.frameMs) {
+        Uint32 steps = state.elapsedMs / clip.frameMs;
+        state.elapsedMs -= steps * clip.frameMs;
+        state.frame = static_cast<Uint16>((state.frame + steps) % clip.frames);
+    }
+}
+
+SDL_Rect AnimationLibrary::frameRect(const AnimState& state) {
+    const AnimClip& clip = clips[state.clip];
+    SDL_Rect src = { state.frame * clip.frameW, 0, clip.frameW, clip.frameH };
+    return src;
+}
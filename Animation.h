@@ -0,0 +1,56 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include "TextureManager.h"
+
+// Compact clip IDs; the names in AnimationLibrary::clipNames map the data file onto these.
+enum AnimClipId : Uint8 {
+    ANIM_PLAYER_IDLE,
+    ANIM_PLAYER_RUN,
+    ANIM_PLAYER_JUMP,
+    ANIM_PLAYER_FALL,
+    ANIM_APPLE,
+    ANIM_BLOCK_IDLE,
+    ANIM_BLOCK_HIT,
+    ANIM_BLOCK_PART_1,
+    ANIM_BLOCK_PART_2,
+    ANIM_SAW,
+    ANIM_SPIKED_BALL,
+    ANIM_SPIKED_BALL_CHAIN,
+    ANIM_SPIKE_HEAD,
+    ANIM_SPIKES,
+    ANIM_FAN,
+    ANIM_MELON,
+    ANIM_PINEAPPLE,
+    ANIM_CLIP_COUNT
+};
+
+struct AnimClip {
+    TextureHandle texture;
+    Uint16 frames = 1;
+    Uint16 frameW = 32;
+    Uint16 frameH = 32;
+    Uint16 frameMs = 100;
+};
+
+// Per-entity playback state; stepping it is a handful of integer ops.
+struct AnimState {
+    Uint8 clip = ANIM_PLAYER_IDLE;
+    Uint16 frame = 0;
+    Uint32 elapsedMs = 0;
+};
+
+class AnimationLibrary {
+public:
+    static bool load(const std::string& path, SDL_Renderer* renderer);
+    static void unload();
+
+    static const AnimClip& get(Uint8 clip) { return clips[clip]; }
+    static void play(AnimState& state, AnimClipId clip);
+    static void advance(AnimState& state, Uint32 dtMs);
+    static SDL_Rect frameRect(const AnimState& state);
+
+private:
+    static AnimClip clips[ANIM_CLIP_COUNT];
+    static const char* const clipNames[ANIM_CLIP_COUNT];
+};
@@ -0,0 +1,229 @@
+// Generated by tools/gen_asset_manifest.py from assets/. Do not edit by hand.
+#pragma once
+#include <SDL.h>
+#include <cstring>
+
+typedef Uint16 AssetId;
+const AssetId INVALID_ASSET = 0xFFFF;
+
+struct AssetInfo {
+    const char* path;
+    Uint16 width, height;    // image size in pixels, 0 for non-images
+    Uint16 frameW, frameH;   // from a "(WxH)" / "WxH" file name, else the whole image
+    Uint16 frames;
+};
+
+enum AssetName : AssetId {
+    ASSET_APPLE,
+    ASSET_BLUE,
+    ASSET_GRAY,
+    ASSET_GREEN,
+    ASSET_MAIN_CHARACTERS_APPEARING,
+    ASSET_MAIN_CHARACTERS_DESAPPEARING,
+    ASSET_MAIN_CHARACTERS_MASK_DUDE_DOUBLE_JUMP,
+    ASSET_MAIN_CHARACTERS_MASK_DUDE_FALL,
+    ASSET_MAIN_CHARACTERS_MASK_DUDE_HIT,
+    ASSET_MAIN_CHARACTERS_MASK_DUDE_IDLE,
+    ASSET_MAIN_CHARACTERS_MASK_DUDE_JUMP,
+    ASSET_MAIN_CHARACTERS_MASK_DUDE_WALL_JUMP,
+    ASSET_MAIN_CHARACTERS_MASK_DUDE_RUN,
+    ASSET_MAIN_CHARACTERS_NINJA_FROG_DOUBLE_JUMP,
+    ASSET_MAIN_CHARACTERS_NINJA_FROG_FALL,
+    ASSET_MAIN_CHARACTERS_NINJA_FROG_HIT,
+    ASSET_MAIN_CHARACTERS_NINJA_FROG_IDLE,
+    ASSET_MAIN_CHARACTERS_NINJA_FROG_JUMP,
+    ASSET_MAIN_CHARACTERS_NINJA_FROG_RUN,
+    ASSET_MAIN_CHARACTERS_NINJA_FROG_WALL_JUMP,
+    ASSET_MAIN_CHARACTERS_PINK_MAN_DOUBLE_JUMP,
+    ASSET_MAIN_CHARACTERS_PINK_MAN_FALL,
+    ASSET_MAIN_CHARACTERS_PINK_MAN_HIT,
+    ASSET_MAIN_CHARACTERS_PINK_MAN_IDLE,
+    ASSET_MAIN_CHARACTERS_PINK_MAN_JUMP,
+    ASSET_MAIN_CHARACTERS_PINK_MAN_RUN,
+    ASSET_MAIN_CHARACTERS_PINK_MAN_WALL_JUMP,
+    ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_DOUBLE_JUMP,
+    ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_FALL,
+    ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_HIT,
+    ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_IDLE,
+    ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_JUMP,
+    ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_RUN,
+    ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_WALL_JUMP,
+    ASSET_MELON,
+    ASSET_PINEAPPLE,
+    ASSET_PURPLE,
+    ASSET_TERRAIN_TERRAIN,
+    ASSET_TRAPS_ARROW_HIT,
+    ASSET_TRAPS_ARROW_IDLE,
+    ASSET_TRAPS_BLOCKS_HITSIDE,
+    ASSET_TRAPS_BLOCKS_HITTOP,
+    ASSET_TRAPS_BLOCKS_IDLE,
+    ASSET_TRAPS_BLOCKS_PART_1,
+    ASSET_TRAPS_BLOCKS_PART_2,
+    ASSET_TRAPS_FALLING_PLATFORMS_OFF,
+    ASSET_TRAPS_FALLING_PLATFORMS_ON,
+    ASSET_TRAPS_FAN_OFF,
+    ASSET_TRAPS_FAN_ON,
+    ASSET_TRAPS_FIRE_HIT,
+    ASSET_TRAPS_FIRE_OFF,
+    ASSET_TRAPS_FIRE_ON,
+    ASSET_TRAPS_PLATFORMS_BROWN_OFF,
+    ASSET_TRAPS_PLATFORMS_BROWN_ON,
+    ASSET_TRAPS_PLATFORMS_CHAIN,
+    ASSET_TRAPS_PLATFORMS_GREY_OFF,
+    ASSET_TRAPS_PLATFORMS_GREY_ON,
+    ASSET_TRAPS_ROCK_HEAD_BLINK,
+    ASSET_TRAPS_ROCK_HEAD_BOTTOM_HIT,
+    ASSET_TRAPS_ROCK_HEAD_IDLE,
+    ASSET_TRAPS_ROCK_HEAD_LEFT_HIT,
+    ASSET_TRAPS_ROCK_HEAD_RIGHT_HIT,
+    ASSET_TRAPS_ROCK_HEAD_TOP_HIT,
+    ASSET_TRAPS_SAND_MUD_ICE_ICE_PARTICLE,
+    ASSET_TRAPS_SAND_MUD_ICE_MUD_PARTICLE,
+    ASSET_TRAPS_SAND_MUD_ICE_SAND_MUD_ICE,
+    ASSET_TRAPS_SAND_MUD_ICE_SAND_PARTICLE,
+    ASSET_TRAPS_SAW_CHAIN,
+    ASSET_TRAPS_SAW_OFF,
+    ASSET_TRAPS_SAW_ON,
+    ASSET_TRAPS_SPIKE_HEAD_BLINK,
+    ASSET_TRAPS_SPIKE_HEAD_BOTTOM_HIT,
+    ASSET_TRAPS_SPIKE_HEAD_IDLE,
+    ASSET_TRAPS_SPIKE_HEAD_LEFT_HIT,
+    ASSET_TRAPS_SPIKE_HEAD_RIGHT_HIT,
+    ASSET_TRAPS_SPIKE_HEAD_TOP_HIT,
+    ASSET_TRAPS_SPIKED_BALL_CHAIN,
+    ASSET_TRAPS_SPIKED_BALL_SPIKED_BALL,
+    ASSET_TRAPS_SPIKES_IDLE,
+    ASSET_TRAPS_TRAMPOLINE_IDLE,
+    ASSET_TRAPS_TRAMPOLINE_JUMP,
+    ASSET_YELLOW,
+    ASSET_ANIMATION_DOUBLEJUMP,
+    ASSET_ANIMATION_FALL,
+    ASSET_ANIMATION_HIT,
+    ASSET_ANIMATION_IDLE,
+    ASSET_ANIMATION_JUMP,
+    ASSET_ANIMATION_RUN,
+    ASSET_ANIMATION_WALLJUMP,
+    ASSET_ANIMATIONS,
+    ASSET_FONT,
+    ASSET_LEVELS_LEVEL1,
+    ASSET_MUSIC_TIME_FOR_ADVENTURE,
+    ASSET_PLATFORMS,
+    ASSET_TERRAIN,
+    ASSET_VECTOR_BLACK_FONT_VECTORBLACK_OAVP,
+    ASSET_VECTOR_BLACK_FONT_INFO,
+    ASSET_COUNT
+};
+
+// Sorted by path so findAsset() can binary search.
+constexpr AssetInfo ASSET_MANIFEST[ASSET_COUNT] = {
+    { "assets/Apple.png", 544, 32, 544, 32, 1 },
+    { "assets/Blue.png", 64, 64, 64, 64, 1 },
+    { "assets/Gray.png", 64, 64, 64, 64, 1 },
+    { "assets/Green.png", 64, 64, 64, 64, 1 },
+    { "assets/Main Characters/Appearing (96x96).png", 672, 96, 96, 96, 7 },
+    { "assets/Main Characters/Desappearing (96x96).png", 672, 96, 96, 96, 7 },
+    { "assets/Main Characters/Mask Dude/Double Jump (32x32).png", 192, 32, 32, 32, 6 },
+    { "assets/Main Characters/Mask Dude/Fall (32x32).png", 32, 32, 32, 32, 1 },
+    { "assets/Main Characters/Mask Dude/Hit (32x32).png", 224, 32, 32, 32, 7 },
+    { "assets/Main Characters/Mask Dude/Idle (32x32).png", 352, 32, 32, 32, 11 },
+    { "assets/Main Characters/Mask Dude/Jump (32x32).png", 32, 32, 32, 32, 1 },
+    { "assets/Main Characters/Mask Dude/Wall Jump (32x32).png", 160, 32, 32, 32, 5 },
+    { "assets/Main Characters/Mask Dude/run32x32.png", 384, 32, 32, 32, 12 },
+    { "assets/Main Characters/Ninja Frog/Double Jump (32x32).png", 192, 32, 32, 32, 6 },
+    { "assets/Main Characters/Ninja Frog/Fall (32x32).png", 32, 32, 32, 32, 1 },
+    { "assets/Main Characters/Ninja Frog/Hit (32x32).png", 224, 32, 32, 32, 7 },
+    { "assets/Main Characters/Ninja Frog/Idle (32x32).png", 352, 32, 32, 32, 11 },
+    { "assets/Main Characters/Ninja Frog/Jump (32x32).png", 32, 32, 32, 32, 1 },
+    { "assets/Main Characters/Ninja Frog/Run (32x32).png", 384, 32, 32, 32, 12 },
+    { "assets/Main Characters/Ninja Frog/Wall Jump (32x32).png", 160, 32, 32, 32, 5 },
+    { "assets/Main Characters/Pink Man/Double Jump (32x32).png", 192, 32, 32, 32, 6 },
+    { "assets/Main Characters/Pink Man/Fall (32x32).png", 32, 32, 32, 32, 1 },
+    { "assets/Main Characters/Pink Man/Hit (32x32).png", 224, 32, 32, 32, 7 },
+    { "assets/Main Characters/Pink Man/Idle (32x32).png", 352, 32, 32, 32, 11 },
+    { "assets/Main Characters/Pink Man/Jump (32x32).png", 32, 32, 32, 32, 1 },
+    { "assets/Main Characters/Pink Man/Run (32x32).png", 384, 32, 32, 32, 12 },
+    { "assets/Main Characters/Pink Man/Wall Jump (32x32).png", 160, 32, 32, 32, 5 },
+    { "assets/Main Characters/Virtual Guy/Double Jump (32x32).png", 192, 32, 32, 32, 6 },
+    { "assets/Main Characters/Virtual Guy/Fall (32x32).png", 32, 32, 32, 32, 1 },
+    { "assets/Main Characters/Virtual Guy/Hit (32x32).png", 224, 32, 32, 32, 7 },
+    { "assets/Main Characters/Virtual Guy/Idle (32x32).png", 352, 32, 32, 32, 11 },
+    { "assets/Main Characters/Virtual Guy/Jump (32x32).png", 32, 32, 32, 32, 1 },
+    { "assets/Main Characters/Virtual Guy/Run (32x32).png", 384, 32, 32, 32, 12 },
+    { "assets/Main Characters/Virtual Guy/Wall Jump (32x32).png", 160, 32, 32, 32, 5 },
+    { "assets/Melon.png", 544, 32, 544, 32, 1 },
+    { "assets/Pineapple.png", 544, 32, 544, 32, 1 },
+    { "assets/Purple.png", 64, 64, 64, 64, 1 },
+    { "assets/Terrain/Terrain (16x16).png", 352, 176, 16, 16, 242 },
+    { "assets/Traps/Arrow/Hit (18x18).png", 72, 18, 18, 18, 4 },
+    { "assets/Traps/Arrow/Idle (18x18).png", 180, 18, 18, 18, 10 },
+    { "assets/Traps/Blocks/HitSide (22x22).png", 66, 22, 22, 22, 3 },
+    { "assets/Traps/Blocks/HitTop (22x22).png", 66, 22, 22, 22, 3 },
+    { "assets/Traps/Blocks/Idle.png", 22, 22, 22, 22, 1 },
+    { "assets/Traps/Blocks/Part 1 (22x22).png", 66, 22, 22, 22, 3 },
+    { "assets/Traps/Blocks/Part 2 (22x22).png", 66, 22, 22, 22, 3 },
+    { "assets/Traps/Falling Platforms/Off.png", 32, 10, 32, 10, 1 },
+    { "assets/Traps/Falling Platforms/On (32x10).png", 128, 10, 32, 10, 4 },
+    { "assets/Traps/Fan/Off.png", 24, 8, 24, 8, 1 },
+    { "assets/Traps/Fan/On (24x8).png", 96, 8, 24, 8, 4 },
+    { "assets/Traps/Fire/Hit (16x32).png", 64, 32, 16, 32, 4 },
+    { "assets/Traps/Fire/Off.png", 16, 32, 16, 32, 1 },
+    { "assets/Traps/Fire/On (16x32).png", 48, 32, 16, 32, 3 },
+    { "assets/Traps/Platforms/Brown Off.png", 32, 8, 32, 8, 1 },
+    { "assets/Traps/Platforms/Brown On (32x8).png", 256, 8, 32, 8, 8 },
+    { "assets/Traps/Platforms/Chain.png", 8, 8, 8, 8, 1 },
+    { "assets/Traps/Platforms/Grey Off.png", 32, 8, 32, 8, 1 },
+    { "assets/Traps/Platforms/Grey On (32x8).png", 256, 8, 32, 8, 8 },
+    { "assets/Traps/Rock Head/Blink (42x42).png", 168, 42, 42, 42, 4 },
+    { "assets/Traps/Rock Head/Bottom Hit (42x42).png", 168, 42, 42, 42, 4 },
+    { "assets/Traps/Rock Head/Idle.png", 42, 42, 42, 42, 1 },
+    { "assets/Traps/Rock Head/Left Hit (42x42).png", 168, 42, 42, 42, 4 },
+    { "assets/Traps/Rock Head/Right Hit (42x42).png", 168, 42, 42, 42, 4 },
+    { "assets/Traps/Rock Head/Top Hit (42x42).png", 168, 42, 42, 42, 4 },
+    { "assets/Traps/Sand Mud Ice/Ice Particle.png", 16, 16, 16, 16, 1 },
+    { "assets/Traps/Sand Mud Ice/Mud Particle.png", 16, 16, 16, 16, 1 },
+    { "assets/Traps/Sand Mud Ice/Sand Mud Ice (16x6).png", 176, 80, 16, 6, 143 },
+    { "assets/Traps/Sand Mud Ice/Sand Particle.png", 16, 16, 16, 16, 1 },
+    { "assets/Traps/Saw/Chain.png", 8, 8, 8, 8, 1 },
+    { "assets/Traps/Saw/Off.png", 38, 38, 38, 38, 1 },
+    { "assets/Traps/Saw/On (38x38).png", 304, 38, 38, 38, 8 },
+    { "assets/Traps/Spike Head/Blink (54x52).png", 216, 52, 54, 52, 4 },
+    { "assets/Traps/Spike Head/Bottom Hit (54x52).png", 216, 52, 54, 52, 4 },
+    { "assets/Traps/Spike Head/Idle.png", 54, 52, 54, 52, 1 },
+    { "assets/Traps/Spike Head/Left Hit (54x52).png", 216, 52, 54, 52, 4 },
+    { "assets/Traps/Spike Head/Right Hit (54x52).png", 216, 52, 54, 52, 4 },
+    { "assets/Traps/Spike Head/Top Hit (54x52).png", 216, 52, 54, 52, 4 },
+    { "assets/Traps/Spiked Ball/Chain.png", 8, 8, 8, 8, 1 },
+    { "assets/Traps/Spiked Ball/Spiked Ball.png", 28, 28, 28, 28, 1 },
+    { "assets/Traps/Spikes/Idle.png", 16, 16, 16, 16, 1 },
+    { "assets/Traps/Trampoline/Idle.png", 28, 28, 28, 28, 1 },
+    { "assets/Traps/Trampoline/Jump (28x28).png", 224, 28, 28, 28, 8 },
+    { "assets/Yellow.png", 64, 64, 64, 64, 1 },
+    { "assets/animation/doublejump32x32.png", 192, 32, 32, 32, 6 },
+    { "assets/animation/fall32x32.png", 32, 32, 32, 32, 1 },
+    { "assets/animation/hit32x32.png", 224, 32, 32, 32, 7 },
+    { "assets/animation/idle32x32.png", 352, 32, 32, 32, 11 },
+    { "assets/animation/jump32x32.png", 32, 32, 32, 32, 1 },
+    { "assets/animation/run32x32.png", 384, 32, 32, 32, 12 },
+    { "assets/animation/walljump32x32.png", 160, 32, 32, 32, 5 },
+    { "assets/animations.txt", 0, 0, 0, 0, 0 },
+    { "assets/font.ttf", 0, 0, 0, 0, 0 },
+    { "assets/levels/level1.lvl", 0, 0, 0, 0, 0 },
+    { "assets/music/time_for_adventure.mp3", 0, 0, 0, 0, 0 },
+    { "assets/platforms.png", 64, 64, 64, 64, 1 },
+    { "assets/terrain16x16.png", 352, 176, 16, 16, 242 },
+    { "assets/vector-black-font/Vectorblack-OAVP.ttf", 0, 0, 0, 0, 0 },
+    { "assets/vector-black-font/info.txt", 0, 0, 0, 0, 0 },
+};
+
+// Exact, case-sensitive lookup for paths that come from data files.
+inline AssetId findAsset(const char* path) {
+    int lo = 0, hi = ASSET_COUNT - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(ASSET_MANIFEST[mid].path, path);
+        if (cmp == 0) return static_cast<AssetId>(mid);
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return INVALID_ASSET;
+}
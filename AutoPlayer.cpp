@@ -0,0 +1,125 @@
+#include "AutoPlayer.h"
+#include "Player.h"
+#include "Constants.h"
+#include <cmath>
+#include <cstring>
+
+// A move that has not landed after this long (about 4 s) is given up on.
+static const int MAX_ACT_TICKS = 240;
+// Without a route: ticks pushing against something before trying a jump.
+static const int STUCK_JUMP_TICKS = 10;
+
+AutoPlayer::AutoPlayer() {
+    reset();
+}
+
+void AutoPlayer::reset() {
+    memset(keys, 0, sizeof(keys));
+    phase = PHASE_PLAN;
+    action = ReachAction();
+    fromNode = -1;
+    targetSpawn = -1;
+    actTicks = 0;
+    alignX = 0.0f;
+    retries = 0;
+    lastX = -1.0f;
+    stuckTicks = 0;
+}
+
+void AutoPlayer::pressDir(int dir) {
+    if (dir < 0) press(SDL_SCANCODE_A);
+    else if (dir > 0) press(SDL_SCANCODE_D);
+}
+
+bool AutoPlayer::plan(const ReachGraph& reach, int node, int appleSpawn) {
+    if (appleSpawn < 0) return false;
+    int touch = reach.spawnTouch(node, appleSpawn);
+    if (touch < 0) return false;
+
+    // Either finish from here, or take the first edge towards the spot that can.
+    const ReachTouch& finish = reach.getTouch(touch);
+    if (finish.node == node) {
+        action = finish.action;
+    }
+    else {
+        int edge = reach.nextEdge(node, finish.node);
+        if (edge < 0) return false;
+        action = reach.getEdge(edge).action;
+    }
+    retries = (node == fromNode && appleSpawn == targetSpawn) ? retries + 1 : 0;
+    fromNode = node;
+    targetSpawn = appleSpawn;
+    // The graph runs every move from the left edge of the standing cell.
+    alignX = static_cast<float>(reach.getNode(node).col * TILE_WIDTH * TILE_SCALE);
+    phase = PHASE_ALIGN;
+    return true;
+}
+
+void AutoPlayer::wander(const Player& player, const SDL_Rect& appleRect) {
+    SDL_Rect body = player.getBounds();
+    int dx = (appleRect.x + appleRect.w / 2) - (body.x + body.w / 2);
+    if (dx < -body.w / 4) pressDir(-1);
+    else if (dx > body.w / 4) pressDir(1);
+    bool appleAbove = appleRect.y + appleRect.h <= body.y;
+    if (player.isOnGround() && (stuckTicks >= STUCK_JUMP_TICKS || appleAbove)) {
+        press(SDL_SCANCODE_SPACE);
+    }
+}
+
+const Uint8* AutoPlayer::think(const Player& player, const ReachGraph& reach, int appleSpawn, const SDL_Rect& appleRect) {
+    memset(keys, 0, sizeof(keys));
+    const bool onGround = player.isOnGround();
+    const float x = player.getX();
+    stuckTicks = (x == lastX) ? stuckTicks + 1 : 0;
+
+    // A new apple changes the route, but a move already under way plays out first.
+    if (appleSpawn != targetSpawn && phase == PHASE_ALIGN) {
+        phase = PHASE_PLAN;
+    }
+
+    // Same end conditions the graph used when it simulated the move.
+    if (phase == PHASE_ACT && actTicks > 0 && onGround) {
+        int at = reach.nodeAt(x, player.getY());
+        if (action.jump || (at >= 0 && at != fromNode) || x == lastX) phase = PHASE_PLAN;
+    }
+    if (phase == PHASE_ACT && actTicks >= MAX_ACT_TICKS) {
+        phase = PHASE_PLAN;
+    }
+    lastX = x;
+
+    if (phase == PHASE_PLAN) {
+        int node = onGround ? reach.nodeAt(x, player.getY()) : -1;
+        if (node < 0 || !plan(reach, node, appleSpawn)) {
+            if (onGround) wander(player, appleRect);
+            return keys;
+        }
+    }
+
+    if (phase == PHASE_ALIGN) {
+        if (!onGround) {
+            phase = PHASE_PLAN;
+            return keys;
+        }
+        // Nearest position, then just right of alignX, then just left.
+        float dx = alignX - x;
+        int side = retries % 3;
+        int dir = 0;
+        if (side == 0 && std::fabs(dx) > MOVE_SPEED * 0.5f) dir = dx < 0.0f ? -1 : 1;
+        else if (side == 1 && (dx > 0.0f || dx <= -MOVE_SPEED)) dir = dx > 0.0f ? 1 : -1;
+        else if (side == 2 && (dx < 0.0f || dx >= MOVE_SPEED)) dir = dx < 0.0f ? -1 : 1;
+        if (dir != 0) {
+            pressDir(dir);
+            // Walled in short of the start: try the move from here instead.
+            if (stuckTicks < STUCK_JUMP_TICKS) return keys;
+            memset(keys, 0, sizeof(keys));
+        }
+        phase = PHASE_ACT;
+        actTicks = 0;
+    }
+
+    // PHASE_ACT: tick n of the move, jump on the first.
+    ++actTicks;
+    if (action.jump && actTicks == 1) press(SDL_SCANCODE_SPACE);
+    if (action.holdTicks == ReachGraph::HOLD_ALL || actTicks <= action.holdTicks) pressDir(action.dir);
+    return keys;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <SDL.h>
+#include "ReachGraph.h"
+
+class Player;
+
+// Computer player for unattended runs (--autoplay). Each tick it fills a
+// keyboard state for Player::handleInput: from the spot the player stands on it
+// looks up the fastest route to the apple's spawn cell in the ReachGraph, walks
+// onto the spot's starting x, then plays the route's next edge (or the final
+// touch) with the same inputs the graph was built from. Whenever the player
+// lands somewhere it plans again, so a missed jump only costs time.
+class AutoPlayer {
+public:
+    AutoPlayer();
+
+    // Forget any move in progress (new round, player respawned).
+    void reset();
+    // Inputs for this tick. appleSpawn is the apple's collectible spawn index, or -1.
+    const Uint8* think(const Player& player, const ReachGraph& reach, int appleSpawn, const SDL_Rect& appleRect);
+
+private:
+    enum Phase : Uint8 { PHASE_PLAN, PHASE_ALIGN, PHASE_ACT };
+
+    void press(SDL_Scancode key) { keys[key] = 1; }
+    void pressDir(int dir);
+    bool plan(const ReachGraph& reach, int node, int appleSpawn);
+    void wander(const Player& player, const SDL_Rect& appleRect);
+
+    Uint8 keys[SDL_NUM_SCANCODES];
+    Phase phase;
+    ReachAction action;
+    int fromNode;
+    int targetSpawn;
+    int actTicks;
+    float alignX;
+    // Moves step MOVE_SPEED at a time, so the start is only reached to within a
+    // step. Planning again from the same spot for the same apple means the last
+    // try failed; each retry starts from the other side of alignX.
+    int retries;
+    float lastX;
+    int stuckTicks;
+};
@@ -0,0 +1,290 @@
+#include "BotSwarm.h"
+#include "Map.h"
+#include "Constants.h"
+#include <cstdio>
+
+// Bots keep a decision for a random 20-80 ticks, and jump at a wall or now and then.
+static const Uint32 DECISION_MIN_TICKS = 20;
+static const Uint32 DECISION_SPREAD_TICKS = 60;
+static const Uint32 JUMP_CHANCE_PERCENT = 30;
+// No point waking a thread for fewer bots than this.
+static const int MIN_BOTS_PER_CHUNK = 64;
+static const int MAX_THREADS = 64;
+
+const int BotSwarm::MAX_BOTS;
+const Uint32 BotSwarm::REPORT_TICKS;
+
+BotSwarm::BotSwarm() :
+    map(nullptr),
+    active(false),
+    fixedPhysics(false),
+    count(0),
+    spawnX(0.0f), spawnY(0.0f),
+    mutex(nullptr),
+    workReady(nullptr),
+    workDone(nullptr),
+    tickGeneration(0),
+    pendingChunks(0),
+    stopRequested(false),
+    ticks(0),
+    totalWallCounts(0), totalBusyCounts(0),
+    windowWallCounts(0), windowBusyCounts(0)
+{
+}
+
+BotSwarm::~BotSwarm() {
+    stop();
+}
+
+bool BotSwarm::start(const Map& gameMap, int botCount, int threadCount, float startX, float startY,
+                     int bodyW, int bodyH, Uint64 seed, bool useFixedPhysics) {
+    stop();
+    if (botCount < 1 || botCount > MAX_BOTS) {
+        printf("Bot swarm: count must be 1-%d, got %d\n", MAX_BOTS, botCount);
+        return false;
+    }
+
+    map = &gameMap;
+    count = botCount;
+    fixedPhysics = useFixedPhysics;
+    spawnX = startX;
+    spawnY = startY;
+
+    PlayerBody body;
+    body.x = spawnX;
+    body.y = spawnY;
+    body.w = static_cast<float>(bodyW);
+    body.h = static_cast<float>(bodyH);
+    PlayerBodyFixed fixedBody;
+    fixedBody.x = Fixed::fromFloat(spawnX);
+    fixedBody.y = Fixed::fromFloat(spawnY);
+    fixedBody.w = Fixed::fromInt(bodyW);
+    fixedBody.h = Fixed::fromInt(bodyH);
+    if (fixedPhysics) fixedBodies.assign(count, fixedBody);
+    else bodies.assign(count, body);
+
+    // One stream per bot so a bot's choices do not depend on how the work is split.
+    Rng seeder(seed);
+    brains.resize(count);
+    for (int i = 0; i < count; ++i) {
+        Brain& brain = brains[i];
+        brain.rng.reseed((static_cast<Uint64>(seeder.next()) << 32) | seeder.next());
+        brain.moveDir = 0;
+        brain.ticksLeft = 0;
+        brain.jump = false;
+    }
+    drawRects.resize(count);
+
+    if (threadCount <= 0) threadCount = SDL_GetCPUCount();
+    if (threadCount > MAX_THREADS) threadCount = MAX_THREADS;
+    int maxChunks = (count + MIN_BOTS_PER_CHUNK - 1) / MIN_BOTS_PER_CHUNK;
+    if (threadCount > maxChunks) threadCount = maxChunks;
+    if (threadCount < 1) threadCount = 1;
+
+    chunkCounts.assign(threadCount, 0);
+    tickGeneration = 0;
+    pendingChunks = 0;
+    stopRequested = false;
+    ticks = 0;
+    totalWallCounts = totalBusyCounts = 0;
+    windowWallCounts = windowBusyCounts = 0;
+
+    // Chunk 0 runs on the calling thread; every other chunk gets a worker.
+    if (threadCount > 1) {
+        mutex = SDL_CreateMutex();
+        workReady = SDL_CreateCond();
+        workDone = SDL_CreateCond();
+        if (!mutex || !workReady || !workDone) {
+            printf("Bot swarm: failed to create thread sync! SDL Error: %s\n", SDL_GetError());
+            stop();
+            return false;
+        }
+        // Sized up front; the threads hold pointers into it.
+        workers.resize(threadCount - 1);
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i].swarm = this;
+            workers[i].chunk = static_cast<int>(i) + 1;
+            workers[i].thread = SDL_CreateThread(workerThreadMain, "BotWorker", &workers[i]);
+            if (!workers[i].thread) {
+                printf("Bot swarm: failed to start worker thread! SDL Error: %s\n", SDL_GetError());
+                stop();
+                return false;
+            }
+        }
+    }
+
+    active = true;
+    printf("Bot swarm: %d bots on %d thread(s), %s physics\n", count, threadCount,
+           fixedPhysics ? "fixed-point" : "float");
+    return true;
+}
+
+void BotSwarm::stop() {
+    if (!workers.empty() && mutex) {
+        SDL_LockMutex(mutex);
+        stopRequested = true;
+        SDL_CondBroadcast(workReady);
+        SDL_UnlockMutex(mutex);
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        if (workers[i].thread) SDL_WaitThread(workers[i].thread, nullptr);
+    }
+    workers.clear();
+    if (workDone) { SDL_DestroyCond(workDone); workDone = nullptr; }
+    if (workReady) { SDL_DestroyCond(workReady); workReady = nullptr; }
+    if (mutex) { SDL_DestroyMutex(mutex); mutex = nullptr; }
+
+    if (active && ticks > 0) {
+        printStats("total", ticks, totalWallCounts, totalBusyCounts);
+    }
+    active = false;
+    bodies.clear();
+    fixedBodies.clear();
+    brains.clear();
+    drawRects.clear();
+    chunkCounts.clear();
+}
+
+int BotSwarm::workerThreadMain(void* data) {
+    Worker* worker = static_cast<Worker*>(data);
+    worker->swarm->workerLoop(worker->chunk);
+    return 0;
+}
+
+void BotSwarm::workerLoop(int chunk) {
+    Uint32 seenGeneration = 0;
+    for (;;) {
+        SDL_LockMutex(mutex);
+        while (tickGeneration == seenGeneration && !stopRequested) {
+            SDL_CondWait(workReady, mutex);
+        }
+        if (stopRequested) {
+            SDL_UnlockMutex(mutex);
+            return;
+        }
+        seenGeneration = tickGeneration;
+        SDL_UnlockMutex(mutex);
+
+        stepChunk(chunk);
+
+        SDL_LockMutex(mutex);
+        if (--pendingChunks == 0) SDL_CondSignal(workDone);
+        SDL_UnlockMutex(mutex);
+    }
+}
+
+void BotSwarm::think(Brain& brain, bool blocked) {
+    brain.jump = false;
+    if (blocked) {
+        brain.jump = true;
+    }
+    if (brain.ticksLeft > 0) {
+        --brain.ticksLeft;
+        return;
+    }
+    brain.ticksLeft = static_cast<Uint16>(DECISION_MIN_TICKS + brain.rng.below(DECISION_SPREAD_TICKS));
+    brain.moveDir = static_cast<int>(brain.rng.below(3)) - 1;
+    brain.jump = brain.jump || brain.rng.below(100) < JUMP_CHANCE_PERCENT;
+}
+
+void BotSwarm::stepChunk(int chunk) {
+    Uint64 begin = SDL_GetPerformanceCounter();
+    int chunkCount = static_cast<int>(chunkCounts.size());
+    int first = static_cast<int>(static_cast<Sint64>(count) * chunk / chunkCount);
+    int last = static_cast<int>(static_cast<Sint64>(count) * (chunk + 1) / chunkCount);
+
+    // A bot that falls off the map goes back to the spawn through the same
+    // Player::resetBody the player respawns with; bots have no coyote state to clear.
+    if (fixedPhysics) {
+        const Fixed bottom = Fixed::fromInt(WINDOW_HEIGHT);
+        for (int i = first; i < last; ++i) {
+            Brain& brain = brains[i];
+            PlayerBodyFixed& body = fixedBodies[i];
+            think(brain, brain.moveDir != 0 && body.velX == Fixed());
+            Player::simulateStepFixed(*map, body, brain.moveDir, brain.jump);
+            if (body.y > bottom) Player::resetBody(body, spawnX, spawnY);
+        }
+    }
+    else {
+        for (int i = first; i < last; ++i) {
+            Brain& brain = brains[i];
+            PlayerBody& body = bodies[i];
+            think(brain, brain.moveDir != 0 && body.velX == 0.0f);
+            Player::simulateStep(*map, body, brain.moveDir, brain.jump);
+            if (body.y > WINDOW_HEIGHT) Player::resetBody(body, spawnX, spawnY);
+        }
+    }
+    chunkCounts[chunk] = SDL_GetPerformanceCounter() - begin;
+}
+
+void BotSwarm::update() {
+    if (!active) return;
+    Uint64 begin = SDL_GetPerformanceCounter();
+
+    if (!workers.empty()) {
+        SDL_LockMutex(mutex);
+        pendingChunks = static_cast<int>(workers.size());
+        ++tickGeneration;
+        SDL_CondBroadcast(workReady);
+        SDL_UnlockMutex(mutex);
+    }
+    stepChunk(0);
+    if (!workers.empty()) {
+        SDL_LockMutex(mutex);
+        while (pendingChunks > 0) {
+            SDL_CondWait(workDone, mutex);
+        }
+        SDL_UnlockMutex(mutex);
+    }
+
+    Uint64 wall = SDL_GetPerformanceCounter() - begin;
+    Uint64 busy = 0;
+    for (size_t i = 0; i < chunkCounts.size(); ++i) {
+        busy += chunkCounts[i];
+    }
+    ++ticks;
+    totalWallCounts += wall;
+    totalBusyCounts += busy;
+    windowWallCounts += wall;
+    windowBusyCounts += busy;
+    if (ticks % REPORT_TICKS == 0) {
+        printStats("last", REPORT_TICKS, windowWallCounts, windowBusyCounts);
+        windowWallCounts = windowBusyCounts = 0;
+    }
+}
+
+void BotSwarm::printStats(const char* label, Uint32 tickCount, Uint64 wallCounts, Uint64 busyCounts) const {
+    if (tickCount == 0 || wallCounts == 0) return;
+    double seconds = static_cast<double>(wallCounts) / SDL_GetPerformanceFrequency();
+    double ticksPerSecond = tickCount / seconds;
+    double usPerTick = seconds * 1e6 / tickCount;
+    double nsPerBot = seconds * 1e9 / (static_cast<double>(tickCount) * count);
+    // Summed thread time over wall time: how many cores the step actually kept busy.
+    double coresBusy = static_cast<double>(busyCounts) / wallCounts;
+    printf("Bot swarm (%s %u ticks): %d bots, %.0f ticks/s, %.1f us/tick, %.1f ns/bot-tick, %.2f cores busy\n",
+           label, tickCount, count, ticksPerSecond, usPerTick, nsPerBot, coresBusy);
+}
+
+void BotSwarm::render(SDL_Renderer* renderer) {
+    if (!active || !renderer) return;
+    for (int i = 0; i < count; ++i) {
+        SDL_Rect& rect = drawRects[i];
+        if (fixedPhysics) {
+            const PlayerBodyFixed& body = fixedBodies[i];
+            rect.x = body.x.floorToInt();
+            rect.y = body.y.floorToInt();
+            rect.w = body.w.floorToInt();
+            rect.h = body.h.floorToInt();
+        }
+        else {
+            const PlayerBody& body = bodies[i];
+            rect.x = static_cast<int>(body.x);
+            rect.y = static_cast<int>(body.y);
+            rect.w = static_cast<int>(body.w);
+            rect.h = static_cast<int>(body.h);
+        }
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 80, 200, 255, 48);
+    SDL_RenderFillRects(renderer, drawRects.data(), count);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "Player.h"
+#include "Rng.h"
+
+class Map;
+
+// Stress mode (--bots N): N computer-driven player bodies on the loaded level,
+// stepped each tick with Player::simulateStep (or simulateStepFixed in
+// deterministic runs), the same physics and tile collision the player uses.
+// The bots are split into contiguous ranges, one per worker thread plus one on
+// the calling thread; the map is only read while they run.
+class BotSwarm {
+public:
+    static const int MAX_BOTS = 10000;
+    // Report cadence, in swarm ticks.
+    static const Uint32 REPORT_TICKS = 300;
+
+    BotSwarm();
+    ~BotSwarm();
+
+    // threadCount 0 uses one thread per CPU core. Bots start at (spawnX, spawnY)
+    // with a body of bodyW x bodyH pixels.
+    bool start(const Map& map, int count, int threadCount, float spawnX, float spawnY,
+               int bodyW, int bodyH, Uint64 seed, bool fixedPhysics);
+    // Joins the workers and prints the totals.
+    void stop();
+
+    // One physics tick for every bot. Returns once all of them have moved; the
+    // map must not change during the call.
+    void update();
+    // Every bot as a translucent box, in one draw call.
+    void render(SDL_Renderer* renderer);
+
+    bool isActive() const { return active; }
+    int getCount() const { return count; }
+
+private:
+    // Per-bot input state; the bodies live in their own arrays so the physics
+    // loop streams through them.
+    struct Brain {
+        Rng rng;
+        int moveDir;
+        Uint16 ticksLeft;   // until the next decision
+        bool jump;
+    };
+    struct Worker {
+        BotSwarm* swarm;
+        int chunk;
+        SDL_Thread* thread;
+    };
+
+    static int workerThreadMain(void* data);
+    void workerLoop(int chunk);
+    void stepChunk(int chunk);
+    void think(Brain& brain, bool blocked);
+    void printStats(const char* label, Uint32 ticks, Uint64 wallCounts, Uint64 busyCounts) const;
+
+    const Map* map;
+    bool active;
+    bool fixedPhysics;
+    int count;
+    float spawnX, spawnY;
+
+    std::vector<PlayerBody> bodies;
+    std::vector<PlayerBodyFixed> fixedBodies;
+    std::vector<Brain> brains;
+    std::vector<SDL_Rect> drawRects;
+
+    // Tick hand-off: update() bumps tickGeneration and waits until pendingChunks
+    // drops to zero. chunkCounts[c] is the time chunk c spent stepping.
+    std::vector<Worker> workers;
+    std::vector<Uint64> chunkCounts;
+    SDL_mutex* mutex;
+    SDL_cond* workReady;
+    SDL_cond* workDone;
+    Uint32 tickGeneration;
+    int pendingChunks;
+    bool stopRequested;
+
+    Uint32 ticks;
+    Uint64 totalWallCounts, totalBusyCounts;
+    Uint64 windowWallCounts, windowBusyCounts;
+};
@@ -0,0 +1,189 @@
+#include "CharacterSkins.h"
+#include <SDL_image.h>
+#include <cstdio>
+
+static_assert(ANIM_PLAYER_IDLE == 0 && ANIM_PLAYER_RUN == 1 && ANIM_PLAYER_JUMP == 2 && ANIM_PLAYER_FALL == 3,
+              "skin sheet table is indexed by player clip id");
+
+const AssetId CharacterSkins::sheets[SKIN_COUNT][SKIN_CLIPS] = {
+    // SKIN_DEFAULT uses the sheets from assets/animations.txt
+    { INVALID_ASSET, INVALID_ASSET, INVALID_ASSET, INVALID_ASSET },
+    { ASSET_MAIN_CHARACTERS_PINK_MAN_IDLE, ASSET_MAIN_CHARACTERS_PINK_MAN_RUN,
+      ASSET_MAIN_CHARACTERS_PINK_MAN_JUMP, ASSET_MAIN_CHARACTERS_PINK_MAN_FALL },
+    { ASSET_MAIN_CHARACTERS_MASK_DUDE_IDLE, ASSET_MAIN_CHARACTERS_MASK_DUDE_RUN,
+      ASSET_MAIN_CHARACTERS_MASK_DUDE_JUMP, ASSET_MAIN_CHARACTERS_MASK_DUDE_FALL },
+    { ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_IDLE, ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_RUN,
+      ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_JUMP, ASSET_MAIN_CHARACTERS_VIRTUAL_GUY_FALL },
+    { ASSET_MAIN_CHARACTERS_NINJA_FROG_IDLE, ASSET_MAIN_CHARACTERS_NINJA_FROG_RUN,
+      ASSET_MAIN_CHARACTERS_NINJA_FROG_JUMP, ASSET_MAIN_CHARACTERS_NINJA_FROG_FALL }
+};
+
+CharacterSkin CharacterSkins::selected = SKIN_DEFAULT;
+TextureHandle CharacterSkins::activeSheets[SKIN_CLIPS];
+SDL_Surface* CharacterSkins::decoded[SKIN_COUNT][SKIN_CLIPS];
+bool CharacterSkins::requested[SKIN_COUNT];
+bool CharacterSkins::failed[SKIN_COUNT];
+bool CharacterSkins::quitLoader = false;
+SDL_mutex* CharacterSkins::mutex = nullptr;
+SDL_cond* CharacterSkins::wake = nullptr;
+SDL_Thread* CharacterSkins::loaderThread = nullptr;
+
+bool CharacterSkins::init() {
+    mutex = SDL_CreateMutex();
+    wake = SDL_CreateCond();
+    quitLoader = false;
+    loaderThread = SDL_CreateThread(loaderThreadMain, "SkinLoader", nullptr);
+    if (!mutex || !wake || !loaderThread) {
+        printf("Skin prefetch thread could not start, skins will load synchronously. SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+void CharacterSkins::shutdown() {
+    if (loaderThread) {
+        SDL_LockMutex(mutex);
+        quitLoader = true;
+        SDL_CondSignal(wake);
+        SDL_UnlockMutex(mutex);
+        SDL_WaitThread(loaderThread, nullptr);
+        loaderThread = nullptr;
+    }
+    for (int skin = 0; skin < SKIN_COUNT; ++skin) {
+        freeDecoded(skin);
+        requested[skin] = false;
+        failed[skin] = false;
+    }
+    for (int clip = 0; clip < SKIN_CLIPS; ++clip) {
+        TextureManager::release(activeSheets[clip]);
+    }
+    if (wake) { SDL_DestroyCond(wake); wake = nullptr; }
+    if (mutex) { SDL_DestroyMutex(mutex); mutex = nullptr; }
+}
+
+const char* CharacterSkins::getName(CharacterSkin skin) {
+    static const char* const names[SKIN_COUNT] = {
+        "Classic", "Pink Man", "Mask Dude", "Virtual Guy", "Ninja Frog"
+    };
+    return skin < SKIN_COUNT ? names[skin] : "?";
+}
+
+void CharacterSkins::select(CharacterSkin skin, SDL_Renderer* renderer) {
+    if (skin >= SKIN_COUNT) return;
+
+    TextureHandle previous[SKIN_CLIPS];
+    for (int clip = 0; clip < SKIN_CLIPS; ++clip) {
+        previous[clip] = activeSheets[clip];
+        activeSheets[clip] = TextureHandle();
+    }
+
+    // Take whatever the loader has finished and stop it working on this skin, so
+    // the lock is never held across a decode or an upload.
+    SDL_Surface* taken[SKIN_CLIPS];
+    if (mutex) SDL_LockMutex(mutex);
+    for (int clip = 0; clip < SKIN_CLIPS; ++clip) {
+        taken[clip] = decoded[skin][clip];
+        decoded[skin][clip] = nullptr;
+    }
+    requested[skin] = false;
+    if (mutex) SDL_UnlockMutex(mutex);
+
+    for (int clip = 0; clip < SKIN_CLIPS; ++clip) {
+        AssetId asset = sheets[skin][clip];
+        if (asset != INVALID_ASSET) {
+            // Uses the prefetched surface when the loader got there first, else decodes now.
+            activeSheets[clip] = TextureManager::acquireFromSurface(asset, taken[clip], renderer,
+                                                                    TEXTURE_CATEGORY_CHARACTER);
+        }
+        if (taken[clip]) SDL_FreeSurface(taken[clip]);
+    }
+
+    // Released after acquiring so re-selecting the same skin never reloads it. The old
+    // sheets stay cached until the texture budget needs the memory.
+    for (int clip = 0; clip < SKIN_CLIPS; ++clip) {
+        TextureManager::release(previous[clip]);
+    }
+    selected = skin;
+    printf("Character skin selected: %s\n", getName(skin));
+}
+
+void CharacterSkins::prefetchAround(CharacterSkin current) {
+    if (!loaderThread) return;
+
+    int next = (current + 1) % SKIN_COUNT;
+    int prev = (current + SKIN_COUNT - 1) % SKIN_COUNT;
+
+    SDL_LockMutex(mutex);
+    bool signal = false;
+    for (int skin = 0; skin < SKIN_COUNT; ++skin) {
+        bool wanted = (skin == next || skin == prev) && skin != selected;
+        if (wanted && !requested[skin] && !failed[skin]) {
+            requested[skin] = true;
+            signal = true;
+        }
+        else if (!wanted && requested[skin]) {
+            requested[skin] = false;
+            freeDecoded(skin);
+        }
+    }
+    if (signal) SDL_CondSignal(wake);
+    SDL_UnlockMutex(mutex);
+}
+
+void CharacterSkins::dropPrefetched() {
+    if (mutex) SDL_LockMutex(mutex);
+    for (int skin = 0; skin < SKIN_COUNT; ++skin) {
+        requested[skin] = false;
+        freeDecoded(skin);
+    }
+    if (mutex) SDL_UnlockMutex(mutex);
+}
+
+void CharacterSkins::freeDecoded(int skin) {
+    for (int clip = 0; clip < SKIN_CLIPS; ++clip) {
+        if (decoded[skin][clip]) {
+            SDL_FreeSurface(decoded[skin][clip]);
+            decoded[skin][clip] = nullptr;
+        }
+    }
+}
+
+int CharacterSkins::loaderThreadMain(void*) {
+    SDL_LockMutex(mutex);
+    while (!quitLoader) {
+        // Find one requested sheet that has not been decoded yet.
+        int skin = -1, clip = -1;
+        for (int s = 0; s < SKIN_COUNT && skin < 0; ++s) {
+            if (!requested[s]) continue;
+            for (int c = 0; c < SKIN_CLIPS; ++c) {
+                if (!decoded[s][c] && sheets[s][c] != INVALID_ASSET) { skin = s; clip = c; break; }
+            }
+        }
+        if (skin < 0) {
+            SDL_CondWait(wake, mutex);
+            continue;
+        }
+
+        // Decode without holding the lock so the game thread never waits on the disk.
+        AssetId asset = sheets[skin][clip];
+        SDL_UnlockMutex(mutex);
+        SDL_Surface* surface = IMG_Load(ASSET_MANIFEST[asset].path);
+        SDL_LockMutex(mutex);
+
+        if (!surface) {
+            printf("Skin prefetch failed for '%s'! SDL_image Error: %s\n", ASSET_MANIFEST[asset].path, IMG_GetError());
+            // The file will not get better by itself; selecting the skin still tries it once.
+            failed[skin] = true;
+            requested[skin] = false;
+            freeDecoded(skin);
+        }
+        else if (!requested[skin] || decoded[skin][clip]) {
+            SDL_FreeSurface(surface);  // dropped while we were decoding
+        }
+        else {
+            decoded[skin][clip] = surface;
+        }
+    }
+    SDL_UnlockMutex(mutex);
+    return 0;
+}
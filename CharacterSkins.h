@@ -0,0 +1,56 @@
+#pragma once
+#include <SDL.h>
+#include "Animation.h"
+#include "TextureManager.h"
+
+enum CharacterSkin : Uint8 {
+    SKIN_DEFAULT,      // assets/animation, loaded with the clip library at startup
+    SKIN_PINK_MAN,
+    SKIN_MASK_DUDE,
+    SKIN_VIRTUAL_GUY,
+    SKIN_NINJA_FROG,
+    SKIN_COUNT
+};
+
+// Player skins loaded on demand. Only the selected skin's sheets are resident;
+// while the menu is open the skins the player is likely to pick next are decoded
+// on a background thread so selecting them only costs the GPU upload.
+class CharacterSkins {
+public:
+    // Player clips are the first entries of AnimClipId.
+    static const int SKIN_CLIPS = ANIM_PLAYER_FALL + 1;
+
+    static bool init();
+    static void shutdown();
+
+    static void select(CharacterSkin skin, SDL_Renderer* renderer);
+    static CharacterSkin getSelected() { return selected; }
+    static const char* getName(CharacterSkin skin);
+
+    // Sheet for a player clip in the selected skin, or nullptr to use the clip's own sheet.
+    static SDL_Texture* sheet(Uint8 clip) {
+        return clip < SKIN_CLIPS ? TextureManager::get(activeSheets[clip]) : nullptr;
+    }
+
+    // Call every frame while the skin menu is open; keeps the neighbours of
+    // 'current' decoded and drops everything else.
+    static void prefetchAround(CharacterSkin current);
+    static void dropPrefetched();
+
+private:
+    static int loaderThreadMain(void* data);
+    static void freeDecoded(int skin);
+
+    static const AssetId sheets[SKIN_COUNT][SKIN_CLIPS];
+    static CharacterSkin selected;
+    static TextureHandle activeSheets[SKIN_CLIPS];
+
+    // Shared with the loader thread, guarded by mutex.
+    static SDL_Surface* decoded[SKIN_COUNT][SKIN_CLIPS];
+    static bool requested[SKIN_COUNT];
+    static bool failed[SKIN_COUNT];     // a sheet would not decode; never prefetched again
+    static bool quitLoader;
+    static SDL_mutex* mutex;
+    static SDL_cond* wake;
+    static SDL_Thread* loaderThread;
+};
@@ -0,0 +1,210 @@
+#include "DynamicTiles.h"
+#include "Constants.h"
+#include <cstdio>
+#include <cstring>
+
+// Block sprites are 22 px frames around a 16 px block, drawn so the block fills its cell.
+static const int BLOCK_SPRITE_INSET = 3;
+// Broken halves drop out of the cell at this acceleration (px per ms^2) and drift sideways.
+static const float DEBRIS_GRAVITY = 0.002f;
+static const float DEBRIS_DRIFT = 0.03f;   // px per ms
+
+const Uint32 DynamicTiles::CRUMBLE_DELAY_MS;
+const Uint32 DynamicTiles::CRUMBLE_RESPAWN_MS;
+const Uint32 DynamicTiles::SWITCH_PERIOD_MS;
+
+DynamicTiles::DynamicTiles() :
+    switchElapsedMs(0),
+    activeGroup(0)
+{
+}
+
+void DynamicTiles::init(Map& map) {
+    blocks.clear();
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+    const LevelEntity* entities = map.getEntities();
+
+    for (int i = 0; i < map.getEntityCount(); ++i) {
+        const LevelEntity& entity = entities[i];
+        Block block = {};
+        if (strcmp(entity.type, "Crumble") == 0) {
+            block.kind = KIND_CRUMBLE;
+            block.delayMs = entity.param > 0 ? static_cast<Uint32>(entity.param) : CRUMBLE_DELAY_MS;
+        }
+        else if (strcmp(entity.type, "SwitchA") == 0 || strcmp(entity.type, "SwitchB") == 0) {
+            if (entity.param <= 0 || entity.param >= LEVEL_TILE_AUTOTILE) {
+                printf("%s at (%d, %d) needs a tileset index as its param\n", entity.type, entity.x, entity.y);
+                continue;
+            }
+            block.kind = KIND_SWITCH;
+            block.group = entity.type[6] == 'B' ? 1 : 0;
+            block.tile = static_cast<Uint16>(entity.param);
+        }
+        else {
+            continue;
+        }
+
+        int col0 = entity.x / tilePixelW, col1 = (entity.x + entity.w - 1) / tilePixelW;
+        int row0 = entity.y / tilePixelH, row1 = (entity.y + entity.h - 1) / tilePixelH;
+        for (int row = row0; row <= row1; ++row) {
+            for (int col = col0; col <= col1; ++col) {
+                if (row < 0 || row >= map.getRows() || col < 0 || col >= map.getCols()) continue;
+                block.row = static_cast<Sint16>(row);
+                block.col = static_cast<Sint16>(col);
+                blocks.push_back(block);
+            }
+        }
+    }
+
+    reset(map);
+    if (!blocks.empty()) {
+        printf("Dynamic tiles: %d blocks\n", static_cast<int>(blocks.size()));
+    }
+}
+
+void DynamicTiles::reset(Map& map) {
+    switchElapsedMs = 0;
+    activeGroup = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        Block& block = blocks[i];
+        bool solid = block.kind == KIND_CRUMBLE || block.group == activeGroup;
+        setPhase(map, block, solid ? PHASE_SOLID : PHASE_OPEN);
+    }
+}
+
+Uint64 DynamicTiles::hashState(Uint64 hash) const {
+    // Field by field so struct padding never leaks in.
+    const Uint32 header[3] = { static_cast<Uint32>(blocks.size()), switchElapsedMs, activeGroup };
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(header);
+    for (size_t i = 0; i < sizeof(header); ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const Uint32 state[2] = { blocks[b].phase, blocks[b].timerMs };
+        bytes = reinterpret_cast<const unsigned char*>(state);
+        for (size_t i = 0; i < sizeof(state); ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+void DynamicTiles::setPhase(Map& map, Block& block, Phase phase) {
+    block.phase = phase;
+    block.timerMs = 0;
+    block.anim.frame = 0;
+    block.anim.elapsedMs = 0;
+    if (phase == PHASE_SOLID) block.anim.clip = ANIM_BLOCK_IDLE;
+    else if (phase == PHASE_SHAKING) block.anim.clip = ANIM_BLOCK_HIT;
+    else block.anim.clip = ANIM_BLOCK_PART_1;
+
+    // Phases are set on every block at reset, so always write the cell through;
+    // the map ignores writes that change nothing.
+    bool solid = phase != PHASE_OPEN;
+    if (block.kind == KIND_SWITCH) {
+        map.setTile(block.row, block.col, solid ? block.tile : 0);
+    }
+    else {
+        map.setSolid(block.row, block.col, solid);
+    }
+}
+
+bool DynamicTiles::overlapsCell(const SDL_Rect& rect, const Block& block) const {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+    int cellX = block.col * tilePixelW;
+    int cellY = block.row * tilePixelH;
+    return rect.x < cellX + tilePixelW && rect.x + rect.w > cellX &&
+           rect.y < cellY + tilePixelH && rect.y + rect.h > cellY;
+}
+
+void DynamicTiles::update(Map& map, const SDL_Rect& player, bool playerOnGround, Uint32 dtMs) {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+
+    switchElapsedMs += dtMs;
+    if (switchElapsedMs >= SWITCH_PERIOD_MS) {
+        switchElapsedMs %= SWITCH_PERIOD_MS;
+        activeGroup ^= 1;
+    }
+
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        Block& block = blocks[i];
+        block.timerMs += dtMs;
+        AnimationLibrary::advance(block.anim, dtMs);
+
+        if (block.kind == KIND_SWITCH) {
+            bool wantSolid = block.group == activeGroup;
+            bool isSolid = block.phase == PHASE_SOLID;
+            // A block never closes around the player; it waits until they have moved off.
+            if (wantSolid != isSolid && (!wantSolid || !overlapsCell(player, block))) {
+                setPhase(map, block, wantSolid ? PHASE_SOLID : PHASE_OPEN);
+            }
+            continue;
+        }
+
+        if (block.phase == PHASE_SOLID) {
+            int cellX = block.col * tilePixelW;
+            int cellY = block.row * tilePixelH;
+            bool standing = playerOnGround && player.y + player.h >= cellY - 1 && player.y + player.h <= cellY + 1 &&
+                            player.x < cellX + tilePixelW && player.x + player.w > cellX;
+            if (standing) setPhase(map, block, PHASE_SHAKING);
+        }
+        else if (block.phase == PHASE_SHAKING) {
+            if (block.timerMs >= block.delayMs) setPhase(map, block, PHASE_OPEN);
+        }
+        else if (block.timerMs >= CRUMBLE_RESPAWN_MS && !overlapsCell(player, block)) {
+            setPhase(map, block, PHASE_SOLID);
+        }
+    }
+}
+
+void DynamicTiles::drawClip(SDL_Renderer* renderer, const AnimState& anim, int x, int y) {
+    const AnimClip& clip = AnimationLibrary::get(anim.clip);
+    SDL_Texture* texture = TextureManager::get(clip.texture);
+    if (!texture) return;
+    SDL_Rect src = AnimationLibrary::frameRect(anim);
+    SDL_Rect dst = { x - BLOCK_SPRITE_INSET * TILE_SCALE, y - BLOCK_SPRITE_INSET * TILE_SCALE,
+                     clip.frameW * TILE_SCALE, clip.frameH * TILE_SCALE };
+    SDL_RenderCopy(renderer, texture, &src, &dst);
+}
+
+void DynamicTiles::render(SDL_Renderer* renderer) {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const Block& block = blocks[i];
+        int x = block.col * tilePixelW;
+        int y = block.row * tilePixelH;
+
+        if (block.kind == KIND_SWITCH) {
+            // Solid switch blocks are part of the baked map; open ones leave an outline.
+            if (block.phase == PHASE_OPEN) {
+                SDL_Rect outline = { x + 4, y + 4, tilePixelW - 8, tilePixelH - 8 };
+                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 96);
+                SDL_RenderDrawRect(renderer, &outline);
+            }
+            continue;
+        }
+
+        if (block.phase != PHASE_OPEN) {
+            drawClip(renderer, block.anim, x, y);
+            continue;
+        }
+
+        // Broken: the two halves fall away until they leave the screen.
+        float t = static_cast<float>(block.timerMs);
+        int fall = static_cast<int>(0.5f * DEBRIS_GRAVITY * t * t);
+        if (y + fall >= WINDOW_HEIGHT) continue;
+        int drift = static_cast<int>(DEBRIS_DRIFT * t);
+        AnimState part = block.anim;
+        drawClip(renderer, part, x - drift, y + fall);
+        part.clip = ANIM_BLOCK_PART_2;
+        drawClip(renderer, part, x + drift, y + fall);
+    }
+}
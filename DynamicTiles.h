@@ -0,0 +1,55 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "Map.h"
+#include "Animation.h"
+
+// Level blocks whose cells change during play. Built from level entities:
+//   Crumble x y w h [delayMs]   gives way delayMs after the player stands on it, then returns
+//   SwitchA / SwitchB x y w h tile   solid in turn, swapping every SWITCH_PERIOD_MS
+// Entities may cover several cells; each cell is its own block. Every change goes
+// through Map::setTile / setSolid, so a frame costs only the cells that changed.
+class DynamicTiles {
+public:
+    static const Uint32 CRUMBLE_DELAY_MS = 500;     // when the entity gives no delay
+    static const Uint32 CRUMBLE_RESPAWN_MS = 3000;
+    static const Uint32 SWITCH_PERIOD_MS = 2000;
+
+    DynamicTiles();
+
+    // Picks the blocks out of the map's entities and applies their starting state.
+    // Call before anything precomputes from the map (reach graph, spawn picks).
+    void init(Map& map);
+    void update(Map& map, const SDL_Rect& player, bool playerOnGround, Uint32 dtMs);
+    void render(SDL_Renderer* renderer);
+    // Puts every block back into its starting state.
+    void reset(Map& map);
+
+    int getBlockCount() const { return static_cast<int>(blocks.size()); }
+    // Mixes every block's phase and timer and the switch clock into an FNV-1a hash,
+    // for the deterministic-run checksum.
+    Uint64 hashState(Uint64 hash) const;
+
+private:
+    enum Kind : Uint8 { KIND_CRUMBLE, KIND_SWITCH };
+    enum Phase : Uint8 { PHASE_SOLID, PHASE_SHAKING, PHASE_OPEN };
+
+    struct Block {
+        Sint16 row, col;
+        Uint8 kind;
+        Uint8 phase;
+        Uint8 group;        // switch blocks: 0 = SwitchA, 1 = SwitchB
+        Uint16 tile;        // switch blocks: tileset index drawn while solid
+        Uint32 delayMs;     // crumble blocks: standing time before breaking
+        Uint32 timerMs;     // time spent in the current phase
+        AnimState anim;
+    };
+
+    void setPhase(Map& map, Block& block, Phase phase);
+    bool overlapsCell(const SDL_Rect& rect, const Block& block) const;
+    void drawClip(SDL_Renderer* renderer, const AnimState& anim, int x, int y);
+
+    std::vector<Block> blocks;
+    Uint32 switchElapsedMs;
+    Uint8 activeGroup;
+};
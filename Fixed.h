@@ -0,0 +1,44 @@
+#pragma once
+#include <SDL.h>
+
+// Q16.16 fixed-point number for the deterministic physics path. Every operation
+// is plain integer arithmetic, so results are identical on any compiler, build
+// flavour or FPU mode; floats only come in through fromFloat() for constants
+// that are exact in binary (0.5, 4.5, 12, ...).
+struct Fixed {
+    static const int FRAC_BITS = 16;
+    static const Sint32 ONE = 1 << FRAC_BITS;
+
+    Sint32 raw;
+
+    static Fixed fromRaw(Sint32 value) { Fixed f; f.raw = value; return f; }
+    static Fixed fromInt(int value) { return fromRaw(value * ONE); }
+    static Fixed fromFloat(float value) { return fromRaw(static_cast<Sint32>(value * ONE)); }
+
+    // Rounds toward negative infinity, like the tile lookups expect.
+    int floorToInt() const { return floorDiv(raw, ONE); }
+    int ceilToInt() const { return -floorDiv(-raw, ONE); }
+    // For drawing and logging only; never feed the result back into the simulation.
+    float toFloat() const { return raw * (1.0f / ONE); }
+
+    // Integer division rounding toward negative infinity (C++ truncates toward zero).
+    static int floorDiv(Sint32 a, Sint32 b) {
+        Sint32 q = a / b;
+        return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    }
+
+    Fixed operator+(Fixed o) const { return fromRaw(raw + o.raw); }
+    Fixed operator-(Fixed o) const { return fromRaw(raw - o.raw); }
+    Fixed operator-() const { return fromRaw(-raw); }
+    Fixed operator*(Fixed o) const { return fromRaw(static_cast<Sint32>((static_cast<Sint64>(raw) * o.raw) >> FRAC_BITS)); }
+    Fixed operator*(int k) const { return fromRaw(raw * k); }
+    Fixed& operator+=(Fixed o) { raw += o.raw; return *this; }
+    Fixed& operator-=(Fixed o) { raw -= o.raw; return *this; }
+
+    bool operator==(Fixed o) const { return raw == o.raw; }
+    bool operator!=(Fixed o) const { return raw != o.raw; }
+    bool operator<(Fixed o) const { return raw < o.raw; }
+    bool operator<=(Fixed o) const { return raw <= o.raw; }
+    bool operator>(Fixed o) const { return raw > o.raw; }
+    bool operator>=(Fixed o) const { return raw >= o.raw; }
+};
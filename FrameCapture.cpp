@@ -0,0 +1,256 @@
+#include "FrameCapture.h"
+#include <SDL_image.h>
+
+FrameCapture::FrameCapture() :
+    renderer(nullptr),
+    format(Format::PNG),
+    everyNthFrame(1),
+    width(0), height(0), pitch(0),
+    active(false),
+    pendingHead(0),
+    pendingCount(0),
+    stopRequested(false),
+    mutex(nullptr),
+    frameReady(nullptr),
+    encoderThread(nullptr),
+    y4mFile(nullptr),
+    frameCounter(0),
+    capturedFrames(0),
+    droppedFrames(0),
+    lastDropReport(0)
+{
+}
+
+FrameCapture::~FrameCapture() {
+    stop();
+}
+
+bool FrameCapture::start(SDL_Renderer* renderer, Format format, const std::string& outputPath,
+                         int frameRateNum, int frameRateDen, int everyNthFrame, int bufferCount) {
+    if (active || !renderer) return false;
+
+    if (SDL_GetRendererOutputSize(renderer, &width, &height) != 0) {
+        printf("Frame capture: cannot query renderer size! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+    // 4:2:0 chroma needs even dimensions.
+    width &= ~1;
+    height &= ~1;
+    pitch = width * 3;
+
+    this->renderer = renderer;
+    this->format = format;
+    this->outputPath = outputPath;
+    this->everyNthFrame = everyNthFrame > 0 ? everyNthFrame : 1;
+    if (bufferCount < 2) bufferCount = 2;
+
+    if (format == Format::Y4M) {
+        y4mFile = fopen(outputPath.c_str(), "wb");
+        if (!y4mFile) {
+            printf("Frame capture: cannot open '%s' for writing\n", outputPath.c_str());
+            return false;
+        }
+        // Only every Nth frame is kept, so the file plays at 1/N of the frame rate;
+        // the header wants the ratio in lowest terms.
+        if (frameRateNum <= 0 || frameRateDen <= 0) {
+            frameRateNum = 60;
+            frameRateDen = 1;
+        }
+        int rateNum = frameRateNum, rateDen = frameRateDen * this->everyNthFrame;
+        int a = rateNum, b = rateDen;
+        while (b != 0) {
+            int r = a % b;
+            a = b;
+            b = r;
+        }
+        fprintf(y4mFile, "YUV4MPEG2 W%d H%d F%d:%d Ip A1:1 C420jpeg\n", width, height, rateNum / a, rateDen / a);
+        yuvPlanes.resize(width * height + 2 * (width / 2) * (height / 2));
+    }
+
+    buffers.resize(bufferCount);
+    freeList.clear();
+    freeList.reserve(bufferCount);
+    pendingRing.assign(bufferCount, -1);
+    for (int i = bufferCount - 1; i >= 0; --i) {
+        buffers[i].pixels.resize(pitch * height);
+        freeList.push_back(i);
+    }
+    pendingHead = 0;
+    pendingCount = 0;
+    stopRequested = false;
+    frameCounter = 0;
+    capturedFrames = 0;
+    droppedFrames = 0;
+    lastDropReport = 0;
+
+    mutex = SDL_CreateMutex();
+    frameReady = SDL_CreateCond();
+    encoderThread = SDL_CreateThread(encoderThreadMain, "FrameEncoder", this);
+    if (!mutex || !frameReady || !encoderThread) {
+        printf("Frame capture: failed to start encoder thread! SDL Error: %s\n", SDL_GetError());
+        stop();
+        return false;
+    }
+
+    active = true;
+    printf("Frame capture started: %s, every %d frame(s), %d buffers -> %s\n",
+           format == Format::PNG ? "PNG" : "Y4M", this->everyNthFrame, bufferCount, outputPath.c_str());
+    return true;
+}
+
+void FrameCapture::stop() {
+    if (encoderThread) {
+        SDL_LockMutex(mutex);
+        stopRequested = true;
+        SDL_CondSignal(frameReady);
+        SDL_UnlockMutex(mutex);
+        // The encoder drains whatever is still queued before it exits.
+        SDL_WaitThread(encoderThread, nullptr);
+        encoderThread = nullptr;
+    }
+    if (frameReady) { SDL_DestroyCond(frameReady); frameReady = nullptr; }
+    if (mutex) { SDL_DestroyMutex(mutex); mutex = nullptr; }
+    if (y4mFile) { fclose(y4mFile); y4mFile = nullptr; }
+
+    if (active) {
+        printf("Frame capture stopped: %u frame(s) written, %u dropped.\n", capturedFrames, droppedFrames);
+    }
+    active = false;
+    buffers.clear();
+    freeList.clear();
+    pendingRing.clear();
+    yuvPlanes.clear();
+}
+
+void FrameCapture::captureFrame() {
+    if (!active) return;
+
+    Uint32 frameNumber = frameCounter++;
+    if (frameNumber % everyNthFrame != 0) return;
+
+    SDL_LockMutex(mutex);
+    int index = -1;
+    if (!freeList.empty()) {
+        index = freeList.back();
+        freeList.pop_back();
+    }
+    SDL_UnlockMutex(mutex);
+
+    if (index < 0) {
+        // Encoder has fallen behind; skip this frame rather than stall the game loop.
+        ++droppedFrames;
+        if (droppedFrames - lastDropReport >= 60 || lastDropReport == 0) {
+            printf("Frame capture: encoder falling behind, %u frame(s) dropped so far\n", droppedFrames);
+            lastDropReport = droppedFrames;
+        }
+        return;
+    }
+
+    FrameBuffer& buffer = buffers[index];
+    buffer.frameNumber = frameNumber;
+    SDL_Rect area = { 0, 0, width, height };
+    if (SDL_RenderReadPixels(renderer, &area, SDL_PIXELFORMAT_RGB24, buffer.pixels.data(), pitch) != 0) {
+        printf("Frame capture: SDL_RenderReadPixels failed! SDL Error: %s\n", SDL_GetError());
+        SDL_LockMutex(mutex);
+        freeList.push_back(index);
+        SDL_UnlockMutex(mutex);
+        return;
+    }
+
+    SDL_LockMutex(mutex);
+    int tail = (pendingHead + pendingCount) % static_cast<int>(pendingRing.size());
+    pendingRing[tail] = index;
+    ++pendingCount;
+    SDL_CondSignal(frameReady);
+    SDL_UnlockMutex(mutex);
+}
+
+int FrameCapture::encoderThreadMain(void* data) {
+    static_cast<FrameCapture*>(data)->encodeLoop();
+    return 0;
+}
+
+void FrameCapture::encodeLoop() {
+    for (;;) {
+        SDL_LockMutex(mutex);
+        while (pendingCount == 0 && !stopRequested) {
+            SDL_CondWait(frameReady, mutex);
+        }
+        if (pendingCount == 0) {
+            SDL_UnlockMutex(mutex);
+            return;
+        }
+        int index = pendingRing[pendingHead];
+        pendingHead = (pendingHead + 1) % static_cast<int>(pendingRing.size());
+        --pendingCount;
+        SDL_UnlockMutex(mutex);
+
+        encodeFrame(buffers[index]);
+
+        SDL_LockMutex(mutex);
+        freeList.push_back(index);
+        ++capturedFrames;
+        SDL_UnlockMutex(mutex);
+    }
+}
+
+void FrameCapture::encodeFrame(const FrameBuffer& buffer) {
+    if (format == Format::PNG) {
+        writePng(buffer);
+    }
+    else {
+        writeY4m(buffer);
+    }
+}
+
+void FrameCapture::writePng(const FrameBuffer& buffer) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(
+        const_cast<Uint8*>(buffer.pixels.data()), width, height, 24, pitch, SDL_PIXELFORMAT_RGB24);
+    if (!surface) {
+        printf("Frame capture: cannot wrap frame %u! SDL Error: %s\n", buffer.frameNumber, SDL_GetError());
+        return;
+    }
+
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "_%06u.png", buffer.frameNumber);
+    std::string path = outputPath + fileName;
+    if (IMG_SavePNG(surface, path.c_str()) != 0) {
+        printf("Frame capture: failed to write '%s'! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
+    }
+    SDL_FreeSurface(surface);
+}
+
+void FrameCapture::writeY4m(const FrameBuffer& buffer) {
+    const int chromaW = width / 2;
+    const int chromaH = height / 2;
+    Uint8* yPlane = yuvPlanes.data();
+    Uint8* uPlane = yPlane + width * height;
+    Uint8* vPlane = uPlane + chromaW * chromaH;
+
+    // BT.601 limited range; chroma is the average of each 2x2 block.
+    for (int cy = 0; cy < chromaH; ++cy) {
+        const Uint8* row0 = buffer.pixels.data() + (cy * 2) * pitch;
+        const Uint8* row1 = row0 + pitch;
+        Uint8* y0 = yPlane + (cy * 2) * width;
+        Uint8* y1 = y0 + width;
+        for (int cx = 0; cx < chromaW; ++cx) {
+            const Uint8* p[4] = { row0 + cx * 6, row0 + cx * 6 + 3, row1 + cx * 6, row1 + cx * 6 + 3 };
+            int sumR = 0, sumG = 0, sumB = 0;
+            for (int k = 0; k < 4; ++k) {
+                int r = p[k][0], g = p[k][1], b = p[k][2];
+                Uint8 luma = static_cast<Uint8>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                if (k == 0) y0[cx * 2] = luma;
+                else if (k == 1) y0[cx * 2 + 1] = luma;
+                else if (k == 2) y1[cx * 2] = luma;
+                else y1[cx * 2 + 1] = luma;
+                sumR += r; sumG += g; sumB += b;
+            }
+            int r = sumR >> 2, g = sumG >> 2, b = sumB >> 2;
+            uPlane[cy * chromaW + cx] = static_cast<Uint8>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[cy * chromaW + cx] = static_cast<Uint8>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+
+    fputs("FRAME\n", y4mFile);
+    fwrite(yuvPlanes.data(), 1, yuvPlanes.size(), y4mFile);
+}
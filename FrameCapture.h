@@ -0,0 +1,71 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+// Reads rendered frames back into a fixed pool of buffers and hands them to a
+// background thread for encoding, so the game loop never waits on the disk.
+class FrameCapture {
+public:
+    enum class Format {
+        PNG,  // one PNG per frame: <outputPath>_000000.png
+        Y4M   // single YUV4MPEG2 (4:2:0) stream written to <outputPath>
+    };
+
+    FrameCapture();
+    ~FrameCapture();
+
+    // Frames arrive at frameRateNum/frameRateDen per second (FramePacer::getFrameRate);
+    // a Y4M stream is stamped with that rate divided by everyNthFrame.
+    bool start(SDL_Renderer* renderer, Format format, const std::string& outputPath,
+               int frameRateNum, int frameRateDen, int everyNthFrame = 1, int bufferCount = 8);
+    void stop();
+
+    // Call after the frame has been drawn and before SDL_RenderPresent.
+    void captureFrame();
+
+    bool isActive() const { return active; }
+    Uint32 getCapturedFrames() const { return capturedFrames; }
+    Uint32 getDroppedFrames() const { return droppedFrames; }
+
+private:
+    struct FrameBuffer {
+        std::vector<Uint8> pixels;
+        Uint32 frameNumber = 0;
+    };
+
+    static int encoderThreadMain(void* data);
+    void encodeLoop();
+    void encodeFrame(const FrameBuffer& buffer);
+    void writePng(const FrameBuffer& buffer);
+    void writeY4m(const FrameBuffer& buffer);
+
+    SDL_Renderer* renderer;
+    Format format;
+    std::string outputPath;
+    int everyNthFrame;
+    int width, height, pitch;
+    bool active;
+
+    // Buffer pool; indices move between freeList and the pending ring under the mutex.
+    std::vector<FrameBuffer> buffers;
+    std::vector<int> freeList;
+    std::vector<int> pendingRing;
+    int pendingHead;
+    int pendingCount;
+    bool stopRequested;
+
+    SDL_mutex* mutex;
+    SDL_cond* frameReady;
+    SDL_Thread* encoderThread;
+
+    // Encoder-thread scratch space, allocated once at start.
+    std::vector<Uint8> yuvPlanes;
+    FILE* y4mFile;
+
+    Uint32 frameCounter;
+    Uint32 capturedFrames;
+    Uint32 droppedFrames;
+    Uint32 lastDropReport;
+};
@@ -0,0 +1,105 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cstdio>
+
+const int FramePacer::WORK_SAMPLES;
+const int FramePacer::RELAX_FRAMES;
+
+static const double MIN_MARGIN_MS = 1.0;
+
+FramePacer::FramePacer() :
+    lateLatch(false),
+    ticksPerMs(1.0),
+    periodMs(16.0),
+    rateNum(1000),
+    rateDen(16),
+    marginMs(2.0),
+    latchMs(0.0),
+    lastPresentMs(0.0),
+    workCount(0),
+    workNext(0),
+    onTimeStreak(0),
+    frames(0),
+    missed(0),
+    slackSumMs(0.0)
+{
+}
+
+void FramePacer::start(SDL_Window* window, int fallbackPeriodMs, bool enabled) {
+    lateLatch = enabled;
+    ticksPerMs = static_cast<double>(SDL_GetPerformanceFrequency()) / 1000.0;
+    rateNum = 1000;
+    rateDen = fallbackPeriodMs > 0 ? fallbackPeriodMs : 16;
+    SDL_DisplayMode mode;
+    if (window && SDL_GetWindowDisplayMode(window, &mode) == 0 && mode.refresh_rate > 0) {
+        rateNum = mode.refresh_rate;
+        rateDen = 1;
+    }
+    periodMs = 1000.0 * rateDen / rateNum;
+    if (lateLatch) {
+        printf("Late-latch pacing: %.2f ms per frame\n", periodMs);
+    }
+}
+
+double FramePacer::nowMs() const {
+    return static_cast<double>(SDL_GetPerformanceCounter()) / ticksPerMs;
+}
+
+double FramePacer::predictedWorkMs() const {
+    if (workCount == 0) return periodMs;    // nothing measured yet: start right away
+    double sorted[WORK_SAMPLES];
+    std::copy(workMs, workMs + workCount, sorted);
+    int p90 = (workCount * 9) / 10;
+    if (p90 >= workCount) p90 = workCount - 1;
+    std::nth_element(sorted, sorted + p90, sorted + workCount);
+    return sorted[p90];
+}
+
+void FramePacer::waitForLatch() {
+    if (!lateLatch || lastPresentMs == 0.0) {
+        latchMs = nowMs();
+        return;
+    }
+    double target = lastPresentMs + periodMs - predictedWorkMs() - marginMs;
+    double now = nowMs();
+    if (target > now) {
+        slackSumMs += target - now;
+        // SDL_Delay can oversleep by a ms or so; sleep short and spin the rest.
+        if (target - now > 2.0) SDL_Delay(static_cast<Uint32>(target - now - 1.0));
+        while (nowMs() < target) {
+        }
+    }
+    latchMs = nowMs();
+}
+
+void FramePacer::beforePresent() {
+    if (!lateLatch) return;
+    workMs[workNext] = nowMs() - latchMs;
+    workNext = (workNext + 1) % WORK_SAMPLES;
+    if (workCount < WORK_SAMPLES) ++workCount;
+}
+
+void FramePacer::afterPresent() {
+    if (!lateLatch) return;
+    double now = nowMs();
+    if (lastPresentMs != 0.0) {
+        ++frames;
+        if (now - lastPresentMs > periodMs * 1.5) {
+            ++missed;
+            onTimeStreak = 0;
+            marginMs = std::min(marginMs + 1.0, periodMs / 2.0);
+        }
+        else if (++onTimeStreak >= RELAX_FRAMES) {
+            onTimeStreak = 0;
+            marginMs = std::max(marginMs - 0.25, MIN_MARGIN_MS);
+        }
+    }
+    lastPresentMs = now;
+}
+
+void FramePacer::printReport() const {
+    if (!lateLatch || frames == 0) return;
+    printf("Late-latch pacing: %u frames, %u missed presents, avg %.2f ms slept before input, "
+           "work p90 %.2f ms, margin %.2f ms\n",
+           frames, missed, slackSumMs / frames, predictedWorkMs(), marginMs);
+}
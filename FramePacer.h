@@ -0,0 +1,50 @@
+#pragma once
+#include <SDL.h>
+
+// Late-latch frame pacing (--late-latch). Instead of polling input at the top
+// of the frame and sleeping after the present, the frame sleeps first and only
+// then polls, simulates and renders, starting just late enough to make the next
+// present. The start time comes from the recent work times (90th percentile of
+// the last WORK_SAMPLES frames) plus a safety margin that grows by a ms whenever
+// a present is missed and creeps back down while frames land on time.
+class FramePacer {
+public:
+    FramePacer();
+
+    // periodMs is used when the display does not report its refresh rate.
+    void start(SDL_Window* window, int fallbackPeriodMs, bool lateLatch);
+    bool isLateLatch() const { return lateLatch; }
+    // The frame period as a rate of num/den frames per second: the display's
+    // refresh rate, or 1000/fallbackPeriodMs when it reports none.
+    void getFrameRate(int& num, int& den) const { num = rateNum; den = rateDen; }
+
+    // Top of the frame, before polling input: sleeps until the latch point.
+    void waitForLatch();
+    // Right before SDL_RenderPresent, and right after it returns.
+    void beforePresent();
+    void afterPresent();
+
+    void printReport() const;
+
+private:
+    static const int WORK_SAMPLES = 64;
+    static const int RELAX_FRAMES = 300;     // on-time presents before the margin shrinks
+
+    double nowMs() const;
+    double predictedWorkMs() const;
+
+    bool lateLatch;
+    double ticksPerMs;
+    double periodMs;
+    int rateNum, rateDen;
+    double marginMs;
+    double latchMs;             // when the current frame's work started
+    double lastPresentMs;       // 0 until the first present
+    double workMs[WORK_SAMPLES];
+    int workCount;
+    int workNext;
+    int onTimeStreak;
+    Uint32 frames;
+    Uint32 missed;
+    double slackSumMs;          // time slept before the latch, summed
+};
@@ -0,0 +1,259 @@
+#include "FruitSystem.h"
+#include "TextureManager.h"
+#include <algorithm>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUITS_USE_SSE2 1
+#endif
+
+const int FruitSystem::CAPACITY;
+const int FruitSystem::HASH_MIN_APPLES;
+const int FruitSystem::SCALE;
+
+const FruitSystem::Kind FruitSystem::KINDS[FRUIT_TYPE_COUNT] = {
+    { ANIM_APPLE,     1, 0,    0 },    // FRUIT_APPLE
+    { ANIM_MELON,     3, 5000, 20 },   // FRUIT_MELON
+    { ANIM_PINEAPPLE, 5, 3500, 10 }    // FRUIT_PINEAPPLE
+};
+
+FruitSystem::FruitSystem() :
+    entity(CAPACITY),
+    type(CAPACITY),
+    cell(CAPACITY),
+    spawnTime(CAPACITY),
+    body(CAPACITY, -1),
+    count(0),
+    appleTarget(1),
+    lastCollectTime(0),
+    world(nullptr),
+    hash(nullptr)
+{
+    hits.reserve(CAPACITY);
+    pairs.reserve(CAPACITY);
+}
+
+void FruitSystem::init(const Map& map, int appleCount, World& world, SpatialHash& hash) {
+    clear();
+    appleTarget = appleCount < 1 ? 1 : (appleCount > CAPACITY / 2 ? CAPACITY / 2 : appleCount);
+    this->world = &world;
+    // A handful of fruit are cheaper to test in one packed pass than to keep filed.
+    this->hash = appleTarget >= HASH_MIN_APPLES ? &hash : nullptr;
+    // A full pool then never grows World's columns or the slot table.
+    world.reserve(world.getEntityCount() + CAPACITY);
+    fruitOfSlot.reserve(world.getEntityCount() + CAPACITY);
+    occupied.assign(map.getCollectibleSpawns().size(), 0);
+    for (int t = 0; t < FRUIT_TYPE_COUNT; ++t) {
+        if (!TextureManager::get(AnimationLibrary::get(KINDS[t].clip).texture)) {
+            printf("Failed to load fruit texture: %s\n", IMG_GetError());
+        }
+    }
+    printf("Fruit pool initialized: %d apple%s out at once%s.\n", appleTarget, appleTarget == 1 ? "" : "s",
+           this->hash ? ", filed in the spatial hash" : "");
+}
+
+void FruitSystem::clear() {
+    while (count > 0) remove(count - 1);
+}
+
+void FruitSystem::reset(const Map& map, Rng& rng, Uint32 now, const std::vector<Uint16>* allowed) {
+    clear();
+    std::fill(occupied.begin(), occupied.end(), 0);
+    for (int n = 0; n < appleTarget; ++n) {
+        if (!spawn(FRUIT_APPLE, map, rng, now, allowed)) break;
+    }
+    lastCollectTime = now;
+}
+
+int FruitSystem::pickCell(const Map& map, Rng& rng, const std::vector<Uint16>* allowed) const {
+    const std::vector<Uint16>& activeSpawns = map.getActiveSpawns();
+    if (activeSpawns.empty()) return -1;
+
+    // The allowed list was computed for the level as loaded; tiles may have filled
+    // some of its cells since, so a few rejected draws fall back to any active cell.
+    // Cells that already hold a fruit are passed over while the draws last.
+    const int TRIES = 8;
+    if (allowed && !allowed->empty()) {
+        for (int attempt = 0; attempt < TRIES; ++attempt) {
+            int candidate = (*allowed)[rng.below(static_cast<Uint32>(allowed->size()))];
+            if (map.isSpawnActive(candidate) && occupied[candidate] == 0) return candidate;
+        }
+    }
+    int pick = -1;
+    for (int attempt = 0; attempt < TRIES; ++attempt) {
+        pick = activeSpawns[rng.below(static_cast<Uint32>(activeSpawns.size()))];
+        if (occupied[pick] == 0) break;
+    }
+    return pick;
+}
+
+bool FruitSystem::spawn(FruitType kind, const Map& map, Rng& rng, Uint32 now, const std::vector<Uint16>* allowed) {
+    if (count == CAPACITY || !world) return false;
+    // Tiles changing at runtime can add spawn cells after init; every index
+    // pickCell may return must have a counter.
+    if (occupied.size() < map.getCollectibleSpawns().size()) {
+        occupied.resize(map.getCollectibleSpawns().size(), 0);
+    }
+    int pick = pickCell(map, rng, allowed);
+    if (pick < 0) {
+        printf("Map has no cells a fruit can spawn in\n");
+        return false;
+    }
+    const SpawnPoint& point = map.getCollectibleSpawns()[pick];
+    const AnimClip& clip = AnimationLibrary::get(KINDS[kind].clip);
+    int i = count++;
+    EntityId id = world->create(World::COMPONENT_TRANSFORM | World::COMPONENT_AABB |
+                                World::COMPONENT_ANIMATION | World::COMPONENT_SPRITE);
+    world->setSprite(id, SCALE, World::RENDER_LAYER_ITEMS);
+    world->setBoxSize(id, clip.frameW * SCALE, clip.frameH * SCALE);
+    world->setPosition(id, static_cast<float>(point.x), static_cast<float>(point.y));
+    world->playClip(id, KINDS[kind].clip);
+    // Each fruit starts its clip at its own frame, so a crowd doesn't spin in step.
+    world->setClipFrame(id, pick);
+    if (fruitOfSlot.size() <= id.slot) fruitOfSlot.resize(id.slot + 1, -1);
+    fruitOfSlot[id.slot] = i;
+    entity[i] = id;
+    type[i] = kind;
+    cell[i] = static_cast<Uint16>(pick);
+    spawnTime[i] = now;
+    if (hash) body[i] = hash->insert(world->getBox(id), SpatialHash::LAYER_COLLECTIBLE, i);
+    ++occupied[pick];
+    return true;
+}
+
+void FruitSystem::remove(int i) {
+    --occupied[cell[i]];
+    if (hash) hash->remove(body[i]);
+    fruitOfSlot[entity[i].slot] = -1;
+    world->destroy(entity[i]);
+    int last = --count;
+    entity[i] = entity[last];
+    type[i] = type[last];
+    cell[i] = cell[last];
+    spawnTime[i] = spawnTime[last];
+    body[i] = body[last];
+    if (i != last) {
+        fruitOfSlot[entity[i].slot] = i;
+        if (hash) hash->setUserData(body[i], i);
+    }
+}
+
+void FruitSystem::update(Uint32 now) {
+    int i = 0;
+    while (i < count) {
+        Uint32 life = KINDS[type[i]].lifeMs;
+        if (life != 0 && now - spawnTime[i] >= life) {
+            remove(i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+int FruitSystem::fruitAt(int dense) const {
+    Uint16 slot = world->getEntityAt(dense).slot;
+    return slot < fruitOfSlot.size() ? fruitOfSlot[slot] : -1;
+}
+
+void FruitSystem::packedOverlap(const SDL_Rect& player) {
+    const SDL_Rect* boxes = world->getBoxes();
+    const int entities = world->getEntityCount();
+    const Sint32 px0 = player.x, py0 = player.y;
+    const Sint32 px1 = player.x + player.w, py1 = player.y + player.h;
+    int d = 0;
+    // World's columns also hold the player and anything else; the slot table keeps only fruit.
+#ifdef FRUITS_USE_SSE2
+    // Open-interval overlap, the same test SpatialHash uses: f.min < p.max && p.min < f.max.
+    const __m128i pMinX = _mm_set1_epi32(px0), pMinY = _mm_set1_epi32(py0);
+    const __m128i pMaxX = _mm_set1_epi32(px1), pMaxY = _mm_set1_epi32(py1);
+    for (; d + 4 <= entities; d += 4) {
+        // Four x, y, w, h rects transposed into x, y, w and h lanes.
+        const __m128i* rects = reinterpret_cast<const __m128i*>(boxes + d);
+        __m128i r0 = _mm_loadu_si128(rects), r1 = _mm_loadu_si128(rects + 1);
+        __m128i r2 = _mm_loadu_si128(rects + 2), r3 = _mm_loadu_si128(rects + 3);
+        __m128i xy01 = _mm_unpacklo_epi32(r0, r1), xy23 = _mm_unpacklo_epi32(r2, r3);
+        __m128i wh01 = _mm_unpackhi_epi32(r0, r1), wh23 = _mm_unpackhi_epi32(r2, r3);
+        __m128i fMinX = _mm_unpacklo_epi64(xy01, xy23);
+        __m128i fMinY = _mm_unpackhi_epi64(xy01, xy23);
+        __m128i fMaxX = _mm_add_epi32(fMinX, _mm_unpacklo_epi64(wh01, wh23));
+        __m128i fMaxY = _mm_add_epi32(fMinY, _mm_unpackhi_epi64(wh01, wh23));
+        __m128i overlap = _mm_and_si128(_mm_and_si128(_mm_cmplt_epi32(fMinX, pMaxX), _mm_cmplt_epi32(pMinX, fMaxX)),
+                                        _mm_and_si128(_mm_cmplt_epi32(fMinY, pMaxY), _mm_cmplt_epi32(pMinY, fMaxY)));
+        int lanes = _mm_movemask_ps(_mm_castsi128_ps(overlap));
+        for (int lane = 0; lanes; ++lane, lanes >>= 1) {
+            if (!(lanes & 1)) continue;
+            int f = fruitAt(d + lane);
+            if (f >= 0) hits.push_back(f);
+        }
+    }
+#endif
+    for (; d < entities; ++d) {
+        const SDL_Rect& b = boxes[d];
+        if (b.x < px1 && px0 < b.x + b.w && b.y < py1 && py0 < b.y + b.h) {
+            int f = fruitAt(d);
+            if (f >= 0) hits.push_back(f);
+        }
+    }
+    // World's order is not the pool's; the removal pass wants pool indices ascending.
+    std::sort(hits.begin(), hits.end());
+}
+
+int FruitSystem::collect(const SDL_Rect& player, const Map& map, Rng& rng, Uint32 now,
+                         const std::vector<Uint16>* allowed, std::vector<Collected>& out) {
+    if (!world) return 0;
+    hits.clear();
+    if (hash) {
+        pairs.clear();
+        hash->queryPairs(SpatialHash::LAYER_PLAYER, SpatialHash::LAYER_COLLECTIBLE, pairs);
+        for (size_t p = 0; p < pairs.size(); ++p) {
+            hits.push_back(hash->getUserData(pairs[p].second));
+        }
+        // Several player bodies may share a fruit; the removal below wants each index once, ascending.
+        std::sort(hits.begin(), hits.end());
+        hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+    }
+    else {
+        packedOverlap(player);
+    }
+    if (hits.empty()) return 0;
+
+    int points = 0;
+    int applesTaken = 0;
+    // Highest index first, so each swap-remove pulls in a fruit already tested.
+    for (int h = static_cast<int>(hits.size()) - 1; h >= 0; --h) {
+        int f = hits[h];
+        const SDL_Rect box = world->getBox(entity[f]);
+        Collected c;
+        c.centerX = box.x + box.w / 2;
+        c.centerY = box.y + box.h / 2;
+        c.type = static_cast<FruitType>(type[f]);
+        c.value = KINDS[type[f]].value;
+        out.push_back(c);
+        points += c.value;
+        if (c.type == FRUIT_APPLE) ++applesTaken;
+        remove(f);
+    }
+    for (int n = 0; n < applesTaken; ++n) {
+        spawn(FRUIT_APPLE, map, rng, now, allowed);
+        Uint32 roll = rng.below(100);
+        for (int t = FRUIT_APPLE + 1; t < FRUIT_TYPE_COUNT; ++t) {
+            if (roll < static_cast<Uint32>(KINDS[t].bonusChance)) {
+                spawn(static_cast<FruitType>(t), map, rng, now, allowed);
+                break;
+            }
+            roll -= KINDS[t].bonusChance;
+        }
+    }
+    lastCollectTime = now;
+    return points;
+}
+
+int FruitSystem::getOldestApple() const {
+    int oldest = -1;
+    for (int i = 0; i < count; ++i) {
+        if (type[i] != FRUIT_APPLE) continue;
+        if (oldest < 0 || static_cast<Sint32>(spawnTime[i] - spawnTime[oldest]) < 0) oldest = i;
+    }
+    return oldest;
+}
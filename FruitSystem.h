@@ -0,0 +1,109 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "Map.h"
+#include "Rng.h"
+#include "Animation.h"
+#include "SpatialHash.h"
+#include "World.h"
+
+enum FruitType : Uint8 {
+    FRUIT_APPLE,
+    FRUIT_MELON,
+    FRUIT_PINEAPPLE,
+    FRUIT_TYPE_COUNT
+};
+
+// Every collectible on the level. Each fruit is a World entity (transform, AABB,
+// animation, sprite on RENDER_LAYER_ITEMS), so World animates and draws
+// them; this keeps the game-side state beside them in a fixed-capacity pool in
+// structure-of-arrays layout. Collecting or expiring a fruit swap-removes it, so
+// the live ones stay packed at the front.
+//
+// Apples are the steady supply: a set number is kept out at all times and they
+// never expire (the game's timer covers them). Each apple picked may bring a
+// melon or a pineapple, worth more and gone again after a few seconds.
+// The player test is one pass over World's packed boxes, four at a time. With
+// HASH_MIN_APPLES or more apples out, fruit are also filed in the game's spatial
+// hash under LAYER_COLLECTIBLE and the test becomes a pair query there instead.
+class FruitSystem {
+public:
+    static const int CAPACITY = 1024;
+    static const int HASH_MIN_APPLES = 64;
+
+    struct Collected {
+        int centerX, centerY;
+        FruitType type;
+        int value;
+    };
+
+    FruitSystem();
+
+    // Sizes the per-cell bookkeeping for 'map'; appleCount apples are kept out from then on.
+    // Fruit entities live in 'world'; 'hash' holds their bodies when there are enough
+    // of them to be worth filing.
+    void init(const Map& map, int appleCount, World& world, SpatialHash& hash);
+    // Clears the pool and puts the apples out. allowed, when given and non-empty,
+    // restricts spawns to those indices of Map::getCollectibleSpawns().
+    void reset(const Map& map, Rng& rng, Uint32 now, const std::vector<Uint16>* allowed);
+    // Drops bonus fruit whose time is up; World steps their animations.
+    void update(Uint32 now);
+    // Removes every fruit overlapping 'player', appends it to 'out' and puts new
+    // apples (and maybe a bonus) out in place of the apples taken. Returns the points.
+    // Fruit filed in the hash are tested against its LAYER_PLAYER bodies, so the
+    // player's body there must already be at 'player'.
+    int collect(const SDL_Rect& player, const Map& map, Rng& rng, Uint32 now,
+                const std::vector<Uint16>* allowed, std::vector<Collected>& out);
+
+    int getCount() const { return count; }
+    // When a fruit was last picked up, or the pool last reset; drives the game timer.
+    Uint32 getLastCollectTime() const { return lastCollectTime; }
+    // The apple that has been out the longest, or -1 when there is none.
+    int getOldestApple() const;
+
+    FruitType getType(int i) const { return static_cast<FruitType>(type[i]); }
+    int getSpawnIndex(int i) const { return cell[i]; }
+    Uint32 getSpawnTime(int i) const { return spawnTime[i]; }
+    SDL_Rect getBox(int i) const { return world->getBox(entity[i]); }
+
+private:
+    struct Kind {
+        AnimClipId clip;
+        int value;          // points
+        Uint32 lifeMs;      // 0 = stays until collected
+        int bonusChance;    // percent per apple collected
+    };
+    static const Kind KINDS[FRUIT_TYPE_COUNT];
+    static const int SCALE = 2;
+
+    bool spawn(FruitType kind, const Map& map, Rng& rng, Uint32 now, const std::vector<Uint16>* allowed);
+    int pickCell(const Map& map, Rng& rng, const std::vector<Uint16>* allowed) const;
+    void remove(int i);
+    void clear();
+    // Appends the pool index of every fruit whose World box overlaps 'player' to hits.
+    void packedOverlap(const SDL_Rect& player);
+    // Pool index of the fruit at World column 'dense', or -1 when that entity is not a fruit.
+    int fruitAt(int dense) const;
+
+    std::vector<EntityId> entity;
+    std::vector<Uint8> type;
+    std::vector<Uint16> cell;
+    std::vector<Uint32> spawnTime;
+    std::vector<int> body;      // hash body per fruit, its user data the pool index
+    int count;
+    int appleTarget;
+    Uint32 lastCollectTime;
+
+    // Pool index of the fruit in each World slot, -1 for slots that hold no fruit.
+    std::vector<int> fruitOfSlot;
+    World* world;
+    // Null while the packed pass is used.
+    SpatialHash* hash;
+
+    // Fruits sitting in each spawn cell; draws prefer empty cells. Grows with the
+    // map's spawn list, which only ever appends.
+    std::vector<Uint16> occupied;
+    // Overlap pass output, pool indices in ascending order.
+    std::vector<int> hits;
+    std::vector<std::pair<int, int>> pairs;
+};
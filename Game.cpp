@@ -1,8 +1,10 @@
 ﻿#include "Game.h"
 #include "TextureManager.h"
+#include "Animation.h"
 #include "Constants.h"
 #include <cstdio>
 #include <sstream>
+#include <iomanip>
 #include <fstream>
 #include <string>
 
@@ -17,42 +19,53 @@ Game::Game() :
     isRunning(false),
     window(nullptr),
     renderer(nullptr),
+    levelPath(ASSET_MANIFEST[ASSET_LEVELS_LEVEL1].path),
+    rngSeed(0),
+    seedRequested(false),
+    lastPlayerNode(-1),
+    fruitCount(1),
+    playerBody(-1),
+    deterministic(false),
+    simTimeMs(0),
+    simTicks(0),
+    lastChecksum(0),
+    checksumLog(nullptr),
+    botCount(0),
+    botThreads(0),
+    botRender(true),
+    autoplay(false),
+    autoplayState(GameState::MENU),
+    autoplayStateFrames(0),
+    soakIntervalMs(60000),
     frameStart(0),
+    lastFrameStart(0),
+    frameDeltaMs(0),
+    tickAccumulatorMs(0),
+    lateLatch(false),
+    jumpBufferMs(100),
+    coyoteMs(80),
     frameTime(0),
     score(0),
     highScore(0),
-    font(nullptr),
-    menuFont(nullptr),
-    gameOverFont(nullptr),
-    scoreTexture(nullptr),
-    highScoreTexture(nullptr),
-    timerTexture(nullptr),
-    gameOverTexture(nullptr),
-    restartTexture(nullptr),
-    playTexture(nullptr),
-    settingsTexture(nullptr),
-    backTexture(nullptr),
-    volumeUpTexture(nullptr),
-    volumeDownTexture(nullptr),
-    volumeDisplayTexture(nullptr),
-    pauseTexture(nullptr),
-    resumeTexture(nullptr),
+    scoreLabel(-1),
+    highScoreLabel(-1),
+    timerLabel(-1),
+    restartButton(-1),
+    playButton(-1),
+    settingsButton(-1),
+    skinButton(-1),
+    menuSkin(SKIN_DEFAULT),
+    backButton(-1),
+    volumeUpButton(-1),
+    volumeDownButton(-1),
+    volumeLabel(-1),
+    resumeButton(-1),
     backgroundMusic(nullptr),
-    musicVolume(64)
+    musicVolume(64),
+    captureRequested(false),
+    captureFormat(FrameCapture::Format::PNG),
+    captureEveryNthFrame(1)
 {
-    scoreRect = { 10, 10, 0, 0 };
-    highScoreRect = { 10, 40, 0, 0 };
-    timerRect = { 10, 70, 0, 0 };
-    gameOverRect = { WINDOW_WIDTH / 2 - 100, WINDOW_HEIGHT / 2 - 50, 0, 0 };
-    restartRect = { WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2 + 20, 100, 40 };
-    playRect = { WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2 - 40, 100, 40 };
-    settingsRect = { WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2 + 20, 100, 40 };
-    backRect = { WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2 + 80, 100, 40 };
-    volumeUpRect = { WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2 - 40, 100, 40 };
-    volumeDownRect = { WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2 + 20, 100, 40 };
-    volumeDisplayRect = { WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2 - 100, 100, 40 };
-    pauseRect = { WINDOW_WIDTH / 2 - 100, WINDOW_HEIGHT / 2 - 50, 0, 0 };
-    resumeRect = { WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2 + 20, 100, 40 };
 }
 
 std::string getExecutableDirectory() {
@@ -113,23 +126,22 @@ Game::~Game() {
 }
 
 void Game::updateVolumeDisplay() {
-    if (!font || !renderer) return;
-
-    if (volumeDisplayTexture) SDL_DestroyTexture(volumeDisplayTexture);
-
+    if (volumeLabel < 0) return;
     std::stringstream ss;
     ss << "Volume: " << musicVolume;
-    SDL_Color textColor = { 255, 255, 255, 255 };
-    SDL_Surface* volumeSurface = TTF_RenderText_Solid(font, ss.str().c_str(), textColor);
-    if (volumeSurface) {
-        volumeDisplayTexture = SDL_CreateTextureFromSurface(renderer, volumeSurface);
-        volumeDisplayRect.w = volumeSurface->w;
-        volumeDisplayRect.h = volumeSurface->h;
-        volumeDisplayRect.x = WINDOW_WIDTH / 2 - volumeDisplayRect.w / 2;
-        SDL_FreeSurface(volumeSurface);
-    }
+    ui.setText(volumeLabel, ss.str());
+}
+void Game::enableFrameCapture(FrameCapture::Format format, const std::string& outputPath, int everyNthFrame) {
+    captureRequested = true;
+    captureFormat = format;
+    capturePath = outputPath;
+    captureEveryNthFrame = everyNthFrame;
 }
 
+void Game::updateSkinDisplay() {
+    if (skinButton < 0) return;
+    ui.setText(skinButton, std::string("Character: ") + CharacterSkins::getName(menuSkin));
+}
 void Game::pauseMusic() {
     if (Mix_PlayingMusic()) {
         Mix_PauseMusic();
@@ -193,15 +205,15 @@ void Game::init(const char* title, int width, int height) {
         return;
     }
 
-    const char* paths[] = {
-        "assets/Yellow.png",
-        "assets/Blue.png",
-        "assets/Green.png",
-        "assets/Purple.png",
-        "assets/Gray.png"
+    const AssetId layers[] = {
+        ASSET_YELLOW,
+        ASSET_BLUE,
+        ASSET_GREEN,
+        ASSET_PURPLE,
+        ASSET_GRAY
     };
     const float speeds[] = { 0.2f, 0.4f, 0.6f, 0.8f, 1.0f };
-    int n = sizeof(paths) / sizeof(paths[0]);
+    int n = sizeof(layers) / sizeof(layers[0]);
 
     bgLayers.reserve(n);
     bgTileW.reserve(n);
@@ -210,14 +222,15 @@ void Game::init(const char* title, int width, int height) {
     bgSpeeds.assign(speeds, speeds + n);
 
     for (int i = 0; i < n; ++i) {
-        SDL_Texture* tex = TextureManager::loadTexture(paths[i], renderer);
+        TextureHandle layer = TextureManager::acquire(layers[i], renderer, TEXTURE_CATEGORY_BACKGROUND);
+        SDL_Texture* tex = TextureManager::get(layer);
         if (!tex) {
-            printf("Failed to load background layer %d: %s\n", i, paths[i]);
+            printf("Failed to load background layer %d: %s\n", i, ASSET_MANIFEST[layers[i]].path);
             SDL_DestroyRenderer(renderer); SDL_DestroyWindow(window); Mix_CloseAudio(); TTF_Quit(); IMG_Quit(); SDL_Quit();
             SDL_Delay(5000);
             return;
         }
-        bgLayers.push_back(tex);
+        bgLayers.push_back(layer);
         int w, h;
         SDL_QueryTexture(tex, nullptr, nullptr, &w, &h);
         bgTileW.push_back(w);
@@ -228,147 +241,86 @@ void Game::init(const char* title, int width, int height) {
     printf("Renderer created.\n");
 
     printf("Loading game resources...\n");
-    map.init("assets/terrain16x16.png", renderer);
-    player.init(renderer);
-    apple.init(renderer, map);
-
-    font = TTF_OpenFont("assets/font.ttf", 24);
-    if (!font) {
-        printf("Failed to load font! TTF Error: %s\n", TTF_GetError());
+    if (!seedRequested) {
+        rngSeed = SDL_GetPerformanceCounter();
+    }
+    rng.reseed(rngSeed);
+    printf("Session seed: %llu (replay with --seed)\n", static_cast<unsigned long long>(rngSeed));
+    AnimationLibrary::load(ASSET_MANIFEST[ASSET_ANIMATIONS].path, renderer);
+    if (!map.init(levelPath.c_str(), renderer)) {
+        printf("Failed to load level: %s\n", levelPath.c_str());
         SDL_DestroyRenderer(renderer); SDL_DestroyWindow(window); Mix_CloseAudio(); TTF_Quit(); IMG_Quit(); SDL_Quit();
         SDL_Delay(5000);
         return;
     }
-
-    menuFont = TTF_OpenFont("assets/font.ttf", 48);
-    if (!menuFont) {
-        printf("Failed to load menu font! TTF Error: %s\n", TTF_GetError());
+    player.init(world);
+    float spawnX, spawnY;
+    if (map.getPlayerSpawn(spawnX, spawnY)) {
+        player.setSpawn(spawnX, spawnY);
+    }
+    player.setFixedPhysics(deterministic);
+    // Assist windows are given in ms; the player counts them in whole ticks.
+    player.setJumpAssist((jumpBufferMs + frameDelay - 1) / frameDelay, (coyoteMs + frameDelay - 1) / frameDelay);
+    if (deterministic && !checksumPath.empty()) {
+        checksumLog = fopen(checksumPath.c_str(), "w");
+        if (!checksumLog) printf("Could not open checksum log '%s'\n", checksumPath.c_str());
+    }
+    // Blocks take their starting state first and hazards block the cells they sweep;
+    // the reach graph and the fruit spawns reflect that layout.
+    dynamicTiles.init(map);
+    playerBody = collisionHash.insert(player.getBounds(), SpatialHash::LAYER_PLAYER);
+    hazards.init(map, collisionHash);
+    std::string reachPath = levelPath.substr(0, levelPath.find_last_of('.')) + ".reach";
+    reach.loadOrBuild(map, reachPath, static_cast<float>(player.getBounds().w), static_cast<float>(player.getBounds().h));
+    reach.setSpawnTimeLimit(appleTimeout);
+    lastPlayerNode = reach.nodeAt(player.getX(), player.getY());
+    fruits.init(map, fruitCount, world, collisionHash);
+    fruits.reset(map, rng, gameClock(), reachableAppleSpawns());
+    collected.reserve(FruitSystem::CAPACITY);
+    if (botCount > 0) {
+        SDL_Rect bounds = player.getBounds();
+        // Bots draw from their own stream so they never shift the game's spawn picks.
+        bots.start(map, botCount, botThreads, player.getX(), player.getY(), bounds.w, bounds.h,
+                   rngSeed ^ 0xB07B07B07B07B07BULL, deterministic);
+    }
+
+    if (!ui.init(renderer, ASSET_MANIFEST[ASSET_FONT].path)) {
         SDL_DestroyRenderer(renderer); SDL_DestroyWindow(window); Mix_CloseAudio(); TTF_Quit(); IMG_Quit(); SDL_Quit();
         SDL_Delay(5000);
         return;
     }
 
-    gameOverFont = TTF_OpenFont("assets/font.ttf", 60);
-    if (!gameOverFont) {
-        printf("Failed to load game over font! TTF Error: %s\n", TTF_GetError());
-        SDL_DestroyRenderer(renderer); SDL_DestroyWindow(window); Mix_CloseAudio(); TTF_Quit(); IMG_Quit(); SDL_Quit();
-        SDL_Delay(5000);
-        return;
-    }
+    // Widgets per screen; labels are rendered on first draw, not here.
+    const SDL_Color green = { 0, 255, 0, 255 };
+    const SDL_Color white = { 255, 255, 255, 255 };
+    const SDL_Color yellow = { 255, 255, 0, 255 };
+    const SDL_Color red = { 255, 0, 0, 255 };
+    playButton = ui.add(UiLayer::SCREEN_MENU, UiLayer::FONT_MENU, green, "Play", UiLayer::PLACE_CENTER, 0, -30, -1, ACTION_PLAY);
+    settingsButton = ui.add(UiLayer::SCREEN_MENU, UiLayer::FONT_MENU, green, "Settings", UiLayer::PLACE_BELOW, 0, 20, playButton, ACTION_SETTINGS);
+    skinButton = ui.add(UiLayer::SCREEN_MENU, UiLayer::FONT_SMALL, white, "Character:", UiLayer::PLACE_BELOW, 0, 20, settingsButton, ACTION_NEXT_SKIN);
+
+    volumeLabel = ui.add(UiLayer::SCREEN_SETTINGS, UiLayer::FONT_SMALL, white, "Volume:", UiLayer::PLACE_CENTER_TOP, 0, -100);
+    volumeUpButton = ui.add(UiLayer::SCREEN_SETTINGS, UiLayer::FONT_MENU, green, "Press to raise volume", UiLayer::PLACE_CENTER, 0, -30, -1, ACTION_VOLUME_UP);
+    volumeDownButton = ui.add(UiLayer::SCREEN_SETTINGS, UiLayer::FONT_MENU, green, "Press to lower volume", UiLayer::PLACE_BELOW, 0, 20, volumeUpButton, ACTION_VOLUME_DOWN);
+    backButton = ui.add(UiLayer::SCREEN_SETTINGS, UiLayer::FONT_MENU, green, "Back", UiLayer::PLACE_CENTER_TOP, 0, 80, -1, ACTION_BACK);
+
+    scoreLabel = ui.add(UiLayer::SCREEN_HUD, UiLayer::FONT_SMALL, white, "Score:", UiLayer::PLACE_TOP_LEFT, 10, 10);
+    highScoreLabel = ui.add(UiLayer::SCREEN_HUD, UiLayer::FONT_SMALL, white, "High Score:", UiLayer::PLACE_TOP_LEFT, 10, 40);
+    timerLabel = ui.add(UiLayer::SCREEN_HUD, UiLayer::FONT_SMALL, yellow, "Time Left:", UiLayer::PLACE_TOP_LEFT, 10, 70);
+
+    int gameOverTitle = ui.add(UiLayer::SCREEN_GAME_OVER, UiLayer::FONT_TITLE, red, "You Lost", UiLayer::PLACE_CENTER, 0, -30);
+    restartButton = ui.add(UiLayer::SCREEN_GAME_OVER, UiLayer::FONT_SMALL, green, "Restart", UiLayer::PLACE_BELOW, 0, 20, gameOverTitle, ACTION_RESTART);
+
+    int pauseTitle = ui.add(UiLayer::SCREEN_PAUSED, UiLayer::FONT_TITLE, white, "Paused", UiLayer::PLACE_CENTER, 0, -30);
+    resumeButton = ui.add(UiLayer::SCREEN_PAUSED, UiLayer::FONT_SMALL, green, "Resume", UiLayer::PLACE_BELOW, 0, 20, pauseTitle, ACTION_RESUME);
 
     loadHighScore();
     updateScoreDisplay();
+    CharacterSkins::init();
+    updateSkinDisplay();
+    updateVolumeDisplay();
 
-    // Initialize menu elements
-    SDL_Color textColor = { 0, 255, 0, 255 };
-    SDL_Surface* playSurface = TTF_RenderText_Solid(menuFont, "Play", textColor);
-    if (playSurface) {
-        playTexture = SDL_CreateTextureFromSurface(renderer, playSurface);
-        playRect.w = playSurface->w;
-        playRect.h = playSurface->h;
-        playRect.x = WINDOW_WIDTH / 2 - playRect.w / 2;
-        playRect.y = WINDOW_HEIGHT / 2 - playRect.h / 2 - 30;
-        SDL_FreeSurface(playSurface);
-        printf("Play button created.\n");
-    }
-
-    SDL_Surface* settingsSurface = TTF_RenderText_Solid(menuFont, "Settings", textColor);
-    if (settingsSurface) {
-        settingsTexture = SDL_CreateTextureFromSurface(renderer, settingsSurface);
-        settingsRect.w = settingsSurface->w;
-        settingsRect.h = settingsSurface->h;
-        settingsRect.x = WINDOW_WIDTH / 2 - settingsRect.w / 2;
-        settingsRect.y = playRect.y + playRect.h + 20;
-        SDL_FreeSurface(settingsSurface);
-        printf("Settings button created.\n");
-    }
-
-    // Initialize settings screen elements
-    SDL_Surface* backSurface = TTF_RenderText_Solid(menuFont, "Back", textColor);
-    if (backSurface) {
-        backTexture = SDL_CreateTextureFromSurface(renderer, backSurface);
-        backRect.w = backSurface->w;
-        backRect.h = backSurface->h;
-        backRect.x = WINDOW_WIDTH / 2 - backRect.w / 2;
-        backRect.y = WINDOW_HEIGHT / 2 + 80;
-        SDL_FreeSurface(backSurface);
-        printf("Back button created.\n");
-    }
-
-    SDL_Surface* volumeUpSurface = TTF_RenderText_Solid(menuFont, "Press to raise volume", textColor);
-    if (volumeUpSurface) {
-        volumeUpTexture = SDL_CreateTextureFromSurface(renderer, volumeUpSurface);
-        volumeUpRect.w = volumeUpSurface->w;
-        volumeUpRect.h = volumeUpSurface->h;
-        volumeUpRect.x = WINDOW_WIDTH / 2 - volumeUpRect.w / 2;
-        volumeUpRect.y = WINDOW_HEIGHT / 2 - volumeUpRect.h / 2 - 30;
-        SDL_FreeSurface(volumeUpSurface);
-        printf("Volume Up button created.\n");
-    }
-
-    SDL_Surface* volumeDownSurface = TTF_RenderText_Solid(menuFont, "Press to lower volume", textColor);
-    if (volumeDownSurface) {
-        volumeDownTexture = SDL_CreateTextureFromSurface(renderer, volumeDownSurface);
-        volumeDownRect.w = volumeDownSurface->w;
-        volumeDownRect.h = volumeDownSurface->h;
-        volumeDownRect.x = WINDOW_WIDTH / 2 - volumeDownRect.w / 2;
-        volumeDownRect.y = volumeUpRect.y + volumeUpRect.h + 20;
-        SDL_FreeSurface(volumeDownSurface);
-        printf("Volume Down button created.\n");
-    }
-
-    updateVolumeDisplay(); // Initialize volume display
-
-    // Initialize game over elements
-    textColor = { 255, 0, 0, 255 };
-    SDL_Surface* gameOverSurface = TTF_RenderText_Solid(gameOverFont, "You Lost", textColor);
-    if (gameOverSurface) {
-        gameOverTexture = SDL_CreateTextureFromSurface(renderer, gameOverSurface);
-        gameOverRect.w = gameOverSurface->w;
-        gameOverRect.h = gameOverSurface->h;
-        gameOverRect.x = WINDOW_WIDTH / 2 - gameOverRect.w / 2;
-        gameOverRect.y = WINDOW_HEIGHT / 2 - gameOverRect.h / 2 - 30;
-        SDL_FreeSurface(gameOverSurface);
-    }
-
-    textColor = { 0, 255, 0, 255 };
-    SDL_Surface* restartSurface = TTF_RenderText_Solid(font, "Restart", textColor);
-    if (restartSurface) {
-        restartTexture = SDL_CreateTextureFromSurface(renderer, restartSurface);
-        restartRect.w = restartSurface->w;
-        restartRect.h = restartSurface->h;
-        restartRect.x = WINDOW_WIDTH / 2 - restartRect.w / 2;
-        restartRect.y = gameOverRect.y + gameOverRect.h + 20;
-        SDL_FreeSurface(restartSurface);
-        printf("Restart button created.\n");
-    }
-
-    // Initialize pause elements
-    textColor = { 255, 255, 255, 255 };
-    SDL_Surface* pauseSurface = TTF_RenderText_Solid(gameOverFont, "Paused", textColor);
-    if (pauseSurface) {
-        pauseTexture = SDL_CreateTextureFromSurface(renderer, pauseSurface);
-        pauseRect.w = pauseSurface->w;
-        pauseRect.h = pauseSurface->h;
-        pauseRect.x = WINDOW_WIDTH / 2 - pauseRect.w / 2;
-        pauseRect.y = WINDOW_HEIGHT / 2 - pauseRect.h / 2 - 30;
-        SDL_FreeSurface(pauseSurface);
-        printf("Pause text created.\n");
-    }
-
-    textColor = { 0, 255, 0, 255 };
-    SDL_Surface* resumeSurface = TTF_RenderText_Solid(font, "Resume", textColor);
-    if (resumeSurface) {
-        resumeTexture = SDL_CreateTextureFromSurface(renderer, resumeSurface);
-        resumeRect.w = resumeSurface->w;
-        resumeRect.h = resumeSurface->h;
-        resumeRect.x = WINDOW_WIDTH / 2 - resumeRect.w / 2;
-        resumeRect.y = pauseRect.y + pauseRect.h + 20;
-        SDL_FreeSurface(resumeSurface);
-        printf("Resume button created.\n");
-    }
-
-    backgroundMusic = Mix_LoadMUS("assets/music/time_for_adventure.mp3");
+    backgroundMusic = Mix_LoadMUS(ASSET_MANIFEST[ASSET_MUSIC_TIME_FOR_ADVENTURE].path);
     if (!backgroundMusic) {
         printf("Failed to load background music! SDL_mixer Error: %s\n", Mix_GetError());
     }
@@ -382,13 +334,31 @@ void Game::init(const char* title, int width, int height) {
         }
     }
 
+    pacer.start(window, frameDelay, lateLatch);
+    if (captureRequested) {
+        // Frames come at the display's refresh rate, as the pacer measured it.
+        int rateNum, rateDen;
+        pacer.getFrameRate(rateNum, rateDen);
+        frameCapture.start(renderer, captureFormat, capturePath, rateNum, rateDen, captureEveryNthFrame);
+    }
+    if (!soakPath.empty()) {
+        soakLog.start(soakPath, soakIntervalMs);
+    }
+    if (autoplay) {
+        printf("Autoplay on: the game plays itself until the window is closed.\n");
+    }
+
     printf("Game resources loaded.\n");
     isRunning = true;
     printf("Game initialized successfully.\n");
 }
 
 void Game::incrementScore() {
-    score += 1;
+    addScore(1);
+}
+
+void Game::addScore(int points) {
+    score += points;
     if (score > highScore) {
         highScore = score;
     }
@@ -396,57 +366,66 @@ void Game::incrementScore() {
 }
 
 void Game::updateScoreDisplay() {
-    if (!font || !renderer) return;
-
-    if (scoreTexture) SDL_DestroyTexture(scoreTexture);
-    if (highScoreTexture) SDL_DestroyTexture(highScoreTexture);
-
+    if (scoreLabel < 0) return;
     std::stringstream ss;
     ss << "Score: " << score;
-    std::string scoreStr = ss.str();
+    ui.setText(scoreLabel, ss.str());
     ss.str("");
     ss << "High Score: " << highScore;
-    std::string highScoreStr = ss.str();
-
-    SDL_Color textColor = { 255, 255, 255, 255 };
-    SDL_Surface* scoreSurface = TTF_RenderText_Solid(font, scoreStr.c_str(), textColor);
-    SDL_Surface* highScoreSurface = TTF_RenderText_Solid(font, highScoreStr.c_str(), textColor);
+    ui.setText(highScoreLabel, ss.str());
+}
+void Game::updateTimerDisplay(Uint32 remainingTime) {
+    if (timerLabel < 0) return;
+    // Tenths are all a player can read anyway, and the label re-renders only when they change.
+    std::stringstream ss;
+    ss << "Time Left: " << std::fixed << std::setprecision(1) << (remainingTime / 100) / 10.0f << "s";
+    ui.setText(timerLabel, ss.str());
+}
+void Game::setDeterministic(bool enabled, const std::string& path) {
+    deterministic = enabled;
+    checksumPath = path;
+}
 
-    if (scoreSurface) {
-        scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
-        scoreRect.w = scoreSurface->w;
-        scoreRect.h = scoreSurface->h;
-        SDL_FreeSurface(scoreSurface);
-    }
-    if (highScoreSurface) {
-        highScoreTexture = SDL_CreateTextureFromSurface(renderer, highScoreSurface);
-        highScoreRect.w = highScoreSurface->w;
-        highScoreRect.h = highScoreSurface->h;
-        SDL_FreeSurface(highScoreSurface);
+static void fnvMix(Uint64& hash, const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
     }
 }
 
-void Game::updateTimerDisplay(Uint32 remainingTime) {
-    if (!font || !renderer) return;
-
-    if (timerTexture) SDL_DestroyTexture(timerTexture);
+Uint64 Game::stateChecksum() const {
+    // Only simulation state, field by field so struct padding never leaks in.
+    Uint64 hash = 14695981039346656037ULL;
+    const Uint64 rngState = rng.getState();
+    fnvMix(hash, &simTicks, sizeof(simTicks));
+    // The jump assist counters decide whether the next press jumps, so they count too.
+    hash = player.hashState(hash);
+    const Sint32 fruitHeader[2] = { fruits.getCount(), static_cast<Sint32>(simTimeMs - fruits.getLastCollectTime()) };
+    fnvMix(hash, fruitHeader, sizeof(fruitHeader));
+    for (int i = 0; i < fruits.getCount(); ++i) {
+        const SDL_Rect box = fruits.getBox(i);
+        const Sint32 fruitState[4] = { box.x, box.y, fruits.getType(i), static_cast<Sint32>(simTimeMs - fruits.getSpawnTime(i)) };
+        fnvMix(hash, fruitState, sizeof(fruitState));
+    }
+    fnvMix(hash, &score, sizeof(score));
+    fnvMix(hash, &rngState, sizeof(rngState));
+    // Crumbling and switching blocks change the collision the player steps against.
+    return dynamicTiles.hashState(hash);
+}
 
-    std::stringstream ss;
-    ss << "Time Left: " << (remainingTime / 1000.0f) << "s";
-    SDL_Color textColor = { 255, 255, 0, 255 };
-    SDL_Surface* timerSurface = TTF_RenderText_Solid(font, ss.str().c_str(), textColor);
-    if (timerSurface) {
-        timerTexture = SDL_CreateTextureFromSurface(renderer, timerSurface);
-        timerRect.w = timerSurface->w;
-        timerRect.h = timerSurface->h;
-        SDL_FreeSurface(timerSurface);
-    }
+const std::vector<Uint16>* Game::reachableAppleSpawns() const {
+    return lastPlayerNode >= 0 ? &reach.spawnsWithinLimit(lastPlayerNode) : nullptr;
 }
 
 void Game::reset() {
     score = 0;
     state = GameState::PLAYING;
-    apple.respawn(map);
+    particles.clear();
+    dynamicTiles.reset(map);
+    hazards.reset(collisionHash);
+    autoPlayer.reset();
+    fruits.reset(map, rng, gameClock(), reachableAppleSpawns());
     updateScoreDisplay();
 }
 
@@ -458,56 +437,71 @@ void Game::handleEvents() {
             return;
         }
 
+        if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+            map.bake(renderer);  // render-target contents are lost with the device
+        }
+
+        if (event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) {
+            inputBuffer.push(event.key);
+        }
+
         if (event.type == SDL_MOUSEBUTTONDOWN) {
-            int x, y;
-            SDL_GetMouseState(&x, &y);
-
-            if (state == GameState::MENU) {
-                if (x >= playRect.x && x <= playRect.x + playRect.w &&
-                    y >= playRect.y && y <= playRect.y + playRect.h) {
-                    state = GameState::PLAYING;
-                    reset();
-                    printf("Play button clicked!\n");
-                }
-                else if (x >= settingsRect.x && x <= settingsRect.x + settingsRect.w &&
-                    y >= settingsRect.y && y <= settingsRect.y + settingsRect.h) {
-                    state = GameState::SETTINGS;
-                    printf("Settings button clicked!\n");
-                }
-            }
-            else if (state == GameState::SETTINGS) {
-                if (x >= backRect.x && x <= backRect.x + backRect.w &&
-                    y >= backRect.y && y <= backRect.y + backRect.h) {
-                    state = GameState::MENU;
-                    printf("Back button clicked!\n");
-                }
-                else if (x >= volumeUpRect.x && x <= volumeUpRect.x + volumeUpRect.w &&
-                    y >= volumeUpRect.y && y <= volumeUpRect.y + volumeUpRect.h) {
-                    musicVolume = (musicVolume + 16 <= 128) ? musicVolume + 16 : 128;
-                    Mix_VolumeMusic(musicVolume);
-                    updateVolumeDisplay();
-                    printf("Volume increased to %d\n", musicVolume);
-                }
-                else if (x >= volumeDownRect.x && x <= volumeDownRect.x + volumeDownRect.w &&
-                    y >= volumeDownRect.y && y <= volumeDownRect.y + volumeDownRect.h) {
-                    musicVolume = (musicVolume - 16 >= 0) ? musicVolume - 16 : 0;
-                    Mix_VolumeMusic(musicVolume);
-                    updateVolumeDisplay();
-                    printf("Volume decreased to %d\n", musicVolume);
-                }
+            // From the event, not the cursor, so synthetic clicks land where they say.
+            int x = event.button.x;
+            int y = event.button.y;
+
+            int action = UiLayer::NO_ACTION;
+            switch (state) {
+            case GameState::MENU:      action = ui.hitTest(UiLayer::SCREEN_MENU, x, y); break;
+            case GameState::SETTINGS:  action = ui.hitTest(UiLayer::SCREEN_SETTINGS, x, y); break;
+            case GameState::GAME_OVER: action = ui.hitTest(UiLayer::SCREEN_GAME_OVER, x, y); break;
+            case GameState::PAUSED:    action = ui.hitTest(UiLayer::SCREEN_PAUSED, x, y); break;
+            default: break;
             }
-            else if (state == GameState::GAME_OVER &&
-                x >= restartRect.x && x <= restartRect.x + restartRect.w &&
-                y >= restartRect.y && y <= restartRect.y + restartRect.h) {
+
+            switch (action) {
+            case ACTION_PLAY:
+                state = GameState::PLAYING;
+                CharacterSkins::dropPrefetched();
+                reset();
+                printf("Play button clicked!\n");
+                break;
+            case ACTION_NEXT_SKIN:
+                menuSkin = static_cast<CharacterSkin>((menuSkin + 1) % SKIN_COUNT);
+                CharacterSkins::select(menuSkin, renderer);
+                updateSkinDisplay();
+                break;
+            case ACTION_SETTINGS:
+                state = GameState::SETTINGS;
+                printf("Settings button clicked!\n");
+                break;
+            case ACTION_BACK:
+                state = GameState::MENU;
+                printf("Back button clicked!\n");
+                break;
+            case ACTION_VOLUME_UP:
+                musicVolume = (musicVolume + 16 <= 128) ? musicVolume + 16 : 128;
+                Mix_VolumeMusic(musicVolume);
+                updateVolumeDisplay();
+                printf("Volume increased to %d\n", musicVolume);
+                break;
+            case ACTION_VOLUME_DOWN:
+                musicVolume = (musicVolume - 16 >= 0) ? musicVolume - 16 : 0;
+                Mix_VolumeMusic(musicVolume);
+                updateVolumeDisplay();
+                printf("Volume decreased to %d\n", musicVolume);
+                break;
+            case ACTION_RESTART:
                 printf("Restart button clicked!\n");
                 reset();
-            }
-            else if (state == GameState::PAUSED &&
-                x >= resumeRect.x && x <= resumeRect.x + resumeRect.w &&
-                y >= resumeRect.y && y <= resumeRect.y + resumeRect.h) {
+                break;
+            case ACTION_RESUME:
                 state = GameState::PLAYING;
                 resumeMusic();
                 printf("Resume button clicked!\n");
+                break;
+            default:
+                break;
             }
         }
 
@@ -527,34 +521,51 @@ void Game::handleEvents() {
 }
 
 void Game::update() {
-    if (state != GameState::PLAYING) return;
-
-    const Uint8* keystate = SDL_GetKeyboardState(NULL);
-    player.handleInput(keystate);
-    player.update(map);
-    apple.update(map);
-
-    SDL_Rect playerRect;
-    playerRect.x = static_cast<int>(player.getX());
-    playerRect.y = static_cast<int>(player.getY());
-    playerRect.w = player.getDstRect().w;
-    playerRect.h = player.getDstRect().h;
-
-    if (apple.isCollected(playerRect)) {
-        incrementScore();
-        apple.respawn(map);
+    if (state == GameState::MENU) {
+        CharacterSkins::prefetchAround(menuSkin);
+    }
+    // The swarm runs in every state, so a stress run needs no one at the keyboard.
+    bots.update();
+    if (state != GameState::PLAYING) {
+        // Keep the held keys current, but nothing typed on a menu carries into play.
+        inputBuffer.sample(SDL_GetTicks());
+        tickAccumulatorMs = 0;
+        return;
     }
 
-    Uint32 currentTime = SDL_GetTicks();
-    Uint32 spawnTime = apple.getSpawnTime();
-    Uint32 timeElapsed = currentTime - spawnTime;
-    if (timeElapsed >= appleTimeout) {
-        state = GameState::GAME_OVER;
-    }
-    else {
-        updateTimerDisplay(appleTimeout - timeElapsed);
+    // Fixed-length ticks, as many as the frame covered. The last one ends now, just
+    // after the poll, and each gets the keys of its own slice of time.
+    const Uint32 now = SDL_GetTicks();
+    tickAccumulatorMs += frameDeltaMs;
+    int ticksRun = 0;
+    while (tickAccumulatorMs >= static_cast<Uint32>(frameDelay) && state == GameState::PLAYING) {
+        tickAccumulatorMs -= frameDelay;
+        const Uint8* keystate;
+        if (autoplay) {
+            int target = fruits.getOldestApple();
+            keystate = autoPlayer.think(player, reach, target >= 0 ? fruits.getSpawnIndex(target) : -1,
+                                        target >= 0 ? fruits.getBox(target) : SDL_Rect());
+        }
+        else {
+            keystate = inputBuffer.sample(now - tickAccumulatorMs);
+        }
+        tick(keystate);
+        if (latency.isEnabled() && !autoplay) {
+            const std::vector<Uint32>& events = inputBuffer.getSampledEvents();
+            Uint32 tickTime = SDL_GetTicks();
+            for (size_t i = 0; i < events.size(); ++i) latency.consumed(events[i], tickTime);
+        }
+        if (++ticksRun == MAX_TICKS_PER_FRAME) {
+            tickAccumulatorMs = 0;  // too far behind; drop the rest rather than spiral
+            break;
+        }
     }
 
+    if (state == GameState::PLAYING) {
+        // Ticks can run past the timeout before the next spawn; show 0 rather than wrap.
+        Uint32 elapsed = gameClock() - fruits.getLastCollectTime();
+        updateTimerDisplay(elapsed < appleTimeout ? appleTimeout - elapsed : 0);
+    }
     for (size_t i = 0; i < bgLayers.size(); ++i) {
         bgOffsets[i] += bgSpeeds[i];
         if (bgOffsets[i] >= bgTileW[i]) {
@@ -563,12 +574,76 @@ void Game::update() {
     }
 }
 
+void Game::tick(const Uint8* keystate) {
+    const Uint32 tickMs = frameDelay;
+    simTimeMs += tickMs;
+    ++simTicks;
+
+    player.handleInput(keystate);
+    player.update(map);
+    // Whole-pixel bounds from here on, so deterministic runs never branch on a float.
+    SDL_Rect playerRect = player.getBounds();
+    if (player.isOnGround()) {
+        int node = reach.nodeAt(static_cast<float>(playerRect.x), static_cast<float>(playerRect.y));
+        if (node >= 0) lastPlayerNode = node;
+    }
+    dynamicTiles.update(map, playerRect, player.isOnGround(), tickMs);
+
+    if (player.hasJustLanded()) {
+        int dustCount = static_cast<int>(player.getLandingSpeed() * 2.0f);
+        particles.emitBurst(player.getX() + playerRect.w / 2.0f, player.getY() + playerRect.h,
+                            dustCount, ParticleSystem::STYLE_LANDING_DUST);
+    }
+
+    collisionHash.update(playerBody, playerRect);
+
+    hazards.update(collisionHash, tickMs);
+    contacts.clear();
+    collisionHash.query(playerRect, SpatialHash::LAYER_HAZARD, contacts);
+    Hazards::Touch hazardTouch = hazards.touch(collisionHash, contacts, playerRect);
+    if (hazardTouch.lethal) {
+        particles.emitBurst(playerRect.x + playerRect.w / 2.0f, playerRect.y + playerRect.h / 2.0f,
+                            32, ParticleSystem::STYLE_LANDING_DUST);
+        player.respawn();
+        playerRect = player.getBounds();
+        collisionHash.update(playerBody, playerRect);
+    }
+    else if (hazardTouch.lift > 0) {
+        player.applyLift(hazardTouch.lift);
+    }
+
+    // A few fruit are one packed pass over World's boxes; --fruits in the hundreds
+    // files them in the hash and pairs them with the player body updated above.
+    fruits.update(gameClock());
+    collected.clear();
+    int points = fruits.collect(playerRect, map, rng, gameClock(), reachableAppleSpawns(), collected);
+    for (size_t i = 0; i < collected.size(); ++i) {
+        particles.emitBurst(static_cast<float>(collected[i].centerX), static_cast<float>(collected[i].centerY),
+                            48, ParticleSystem::STYLE_APPLE_COLLECT);
+    }
+    if (points > 0) addScore(points);
+    world.updateAnimations(tickMs);
+    particles.update(tickMs);
+
+    if (gameClock() - fruits.getLastCollectTime() >= appleTimeout) {
+        state = GameState::GAME_OVER;
+    }
+
+    if (deterministic) {
+        lastChecksum = stateChecksum();
+        if (checksumLog) {
+            fprintf(checksumLog, "%u %016llx\n", simTicks, static_cast<unsigned long long>(lastChecksum));
+        }
+    }
+}
+
 void Game::render() {
     SDL_SetRenderDrawColor(renderer, 135, 206, 235, 255);
     SDL_RenderClear(renderer);
 
     for (size_t i = 0; i < bgLayers.size(); ++i) {
-        SDL_Texture* tex = bgLayers[i];
+        SDL_Texture* tex = TextureManager::get(bgLayers[i]);
+        if (!tex) continue;
         int tw = bgTileW[i], th = bgTileH[i];
         int off = static_cast<int>(bgOffsets[i]);
 
@@ -581,35 +656,67 @@ void Game::render() {
     }
 
     if (state == GameState::MENU) {
-        if (playTexture) SDL_RenderCopy(renderer, playTexture, nullptr, &playRect);
-        if (settingsTexture) SDL_RenderCopy(renderer, settingsTexture, nullptr, &settingsRect);
+        ui.render(UiLayer::SCREEN_MENU);
     }
     else if (state == GameState::SETTINGS) {
-        if (volumeDisplayTexture) SDL_RenderCopy(renderer, volumeDisplayTexture, nullptr, &volumeDisplayRect);
-        if (volumeUpTexture) SDL_RenderCopy(renderer, volumeUpTexture, nullptr, &volumeUpRect);
-        if (volumeDownTexture) SDL_RenderCopy(renderer, volumeDownTexture, nullptr, &volumeDownRect);
-        if (backTexture) SDL_RenderCopy(renderer, backTexture, nullptr, &backRect);
+        ui.render(UiLayer::SCREEN_SETTINGS);
     }
     else {
         map.render(renderer);
-        player.render(renderer);
-        apple.render(renderer);
-
-        if (scoreTexture) SDL_RenderCopy(renderer, scoreTexture, nullptr, &scoreRect);
-        if (highScoreTexture) SDL_RenderCopy(renderer, highScoreTexture, nullptr, &highScoreRect);
-        if (timerTexture && state == GameState::PLAYING) SDL_RenderCopy(renderer, timerTexture, nullptr, &timerRect);
-
-        if (state == GameState::GAME_OVER && gameOverTexture) {
-            SDL_RenderCopy(renderer, gameOverTexture, nullptr, &gameOverRect);
-            if (restartTexture) SDL_RenderCopy(renderer, restartTexture, nullptr, &restartRect);
+        dynamicTiles.render(renderer);
+        hazards.render(renderer);
+        world.render(renderer);
+        if (botRender) bots.render(renderer);
+        particles.render(renderer);
+
+        ui.setVisible(timerLabel, state == GameState::PLAYING);
+        ui.render(UiLayer::SCREEN_HUD);
+        if (state == GameState::GAME_OVER) {
+            ui.render(UiLayer::SCREEN_GAME_OVER);
         }
         else if (state == GameState::PAUSED) {
-            if (pauseTexture) SDL_RenderCopy(renderer, pauseTexture, nullptr, &pauseRect);
-            if (resumeTexture) SDL_RenderCopy(renderer, resumeTexture, nullptr, &resumeRect);
+            ui.render(UiLayer::SCREEN_PAUSED);
         }
     }
 
+    frameCapture.captureFrame();
+    pacer.beforePresent();
     SDL_RenderPresent(renderer);
+    pacer.afterPresent();
+    latency.presented(SDL_GetTicks());
+}
+
+static void pushClick(const SDL_Rect& button) {
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = SDL_MOUSEBUTTONDOWN;
+    event.button.button = SDL_BUTTON_LEFT;
+    event.button.state = SDL_PRESSED;
+    event.button.clicks = 1;
+    event.button.x = button.x + button.w / 2;
+    event.button.y = button.y + button.h / 2;
+    SDL_PushEvent(&event);
+}
+
+void Game::driveAutoplayMenus() {
+    // Counted in frames rather than ms so deterministic runs click on the same tick.
+    const Uint32 SCREEN_WAIT_FRAMES = 90;
+    if (state != autoplayState) {
+        autoplayState = state;
+        autoplayStateFrames = 0;
+    }
+    ++autoplayStateFrames;
+
+    if (state == GameState::MENU) {
+        // Change skin on the way through, so character sheets keep loading and unloading.
+        if (autoplayStateFrames == SCREEN_WAIT_FRAMES / 2) pushClick(ui.getRect(skinButton));
+        else if (autoplayStateFrames == SCREEN_WAIT_FRAMES) pushClick(ui.getRect(playButton));
+    }
+    else if (autoplayStateFrames == SCREEN_WAIT_FRAMES) {
+        if (state == GameState::GAME_OVER) pushClick(ui.getRect(restartButton));
+        else if (state == GameState::PAUSED) pushClick(ui.getRect(resumeButton));
+        else if (state == GameState::SETTINGS) pushClick(ui.getRect(backButton));
+    }
 }
 
 void Game::run() {
@@ -619,12 +726,22 @@ void Game::run() {
         return;
     }
     while (running()) {
+        // Late latch sleeps here, so input is polled as close to the present as it can be.
+        pacer.waitForLatch();
         frameStart = SDL_GetTicks();
+        // Cap the step so a long stall (window drag, breakpoint) doesn't fast-forward animations.
+        frameDeltaMs = lastFrameStart ? frameStart - lastFrameStart : frameDelay;
+        if (frameDeltaMs > 100) frameDeltaMs = 100;
+        // Deterministic runs advance by exactly one tick per frame, however long it took.
+        if (deterministic) frameDeltaMs = frameDelay;
+        if (lastFrameStart) soakLog.recordFrame(frameStart - lastFrameStart, frameStart);
+        lastFrameStart = frameStart;
+        if (autoplay) driveAutoplayMenus();
         handleEvents();
         update();
         render();
         frameTime = SDL_GetTicks() - frameStart;
-        if (frameDelay > frameTime) {
+        if (!pacer.isLateLatch() && frameDelay > frameTime) {
             SDL_Delay(frameDelay - frameTime);
         }
     }
@@ -634,24 +751,29 @@ void Game::run() {
 void Game::clean() {
     printf("Cleaning up game...\n");
     saveHighScore();
+    if (deterministic) {
+        printf("Deterministic run: %u ticks, final state checksum %016llx\n", simTicks,
+               static_cast<unsigned long long>(lastChecksum));
+    }
+    if (checksumLog) {
+        fclose(checksumLog);
+        checksumLog = nullptr;
+    }
+    frameCapture.stop();
+    bots.stop();
+    soakLog.stop();
+    latency.printReport();
+    pacer.printReport();
+    for (size_t i = 0; i < bgLayers.size(); ++i) {
+        TextureManager::release(bgLayers[i]);
+    }
+    bgLayers.clear();
+    AnimationLibrary::unload();
+    CharacterSkins::shutdown();
+    map.shutdown();
     TextureManager::cleanUp();
 
-    if (scoreTexture) SDL_DestroyTexture(scoreTexture);
-    if (highScoreTexture) SDL_DestroyTexture(highScoreTexture);
-    if (timerTexture) SDL_DestroyTexture(timerTexture);
-    if (gameOverTexture) SDL_DestroyTexture(gameOverTexture);
-    if (restartTexture) SDL_DestroyTexture(restartTexture);
-    if (playTexture) SDL_DestroyTexture(playTexture);
-    if (settingsTexture) SDL_DestroyTexture(settingsTexture);
-    if (backTexture) SDL_DestroyTexture(backTexture);
-    if (volumeUpTexture) SDL_DestroyTexture(volumeUpTexture);
-    if (volumeDownTexture) SDL_DestroyTexture(volumeDownTexture);
-    if (volumeDisplayTexture) SDL_DestroyTexture(volumeDisplayTexture);
-    if (pauseTexture) SDL_DestroyTexture(pauseTexture);
-    if (resumeTexture) SDL_DestroyTexture(resumeTexture);
-    if (font) TTF_CloseFont(font);
-    if (menuFont) TTF_CloseFont(menuFont);
-    if (gameOverFont) TTF_CloseFont(gameOverFont);
+    ui.shutdown();
     if (backgroundMusic) {
         Mix_FreeMusic(backgroundMusic);
         printf("Background music freed.\n");
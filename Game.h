@@ -2,10 +2,28 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
+#include "TextureManager.h"
 #include "Map.h"
 #include "Player.h"
 #include <vector>
-#include "apple.h"
+#include "FruitSystem.h"
+#include "UiLayer.h"
+#include "FrameCapture.h"
+#include "ParticleSystem.h"
+#include "CharacterSkins.h"
+#include "SpatialHash.h"
+#include "Rng.h"
+#include "ReachGraph.h"
+#include "DynamicTiles.h"
+#include "World.h"
+#include "BotSwarm.h"
+#include "AutoPlayer.h"
+#include "SoakLog.h"
+#include "Hazards.h"
+#include "InputBuffer.h"
+#include "LatencyStats.h"
+#include "FramePacer.h"
+#include <string>
 
 class Game {
 public:
@@ -16,6 +34,31 @@ public:
     void run();
     bool running() const;
     void incrementScore();
+    void addScore(int points);
+    void enableFrameCapture(FrameCapture::Format format, const std::string& outputPath, int everyNthFrame);
+    void setLevelPath(const std::string& path) { levelPath = path; }
+    // Fixes the session seed so a run can be replayed; otherwise one is picked at init.
+    void setSeed(Uint64 seed) { rngSeed = seed; seedRequested = true; }
+    // Fixed-point player physics and a tick-counted game clock, so the same seed and
+    // inputs give bit-identical runs. checksumPath, when set, receives one
+    // "tick checksum" line per simulated tick for diffing two runs.
+    void setDeterministic(bool enabled, const std::string& checksumPath);
+    // Stress mode: count simulated players on the level from init on (0 = off).
+    // threads 0 uses every core; render false leaves them off screen.
+    void setBotSwarm(int count, int threads, bool render) { botCount = count; botThreads = threads; botRender = render; }
+    // Unattended play: the AutoPlayer steers, and the menus, restart and pause
+    // screens are clicked through by synthetic mouse events.
+    void setAutoplay(bool enabled) { autoplay = enabled; }
+    // Appends a SoakLog row to path every intervalMs from init on.
+    void setSoakLog(const std::string& path, Uint32 intervalMs) { soakPath = path; soakIntervalMs = intervalMs; }
+    // Jump buffering and coyote time windows in ms; 0 turns one off.
+    void setJumpAssist(int bufferMs, int graceMs) { jumpBufferMs = bufferMs; coyoteMs = graceMs; }
+    // Measures key-to-present latency, with a live line and a histogram at exit.
+    void setLatencyStats(bool enabled) { latency.setEnabled(enabled); }
+    // Sleep at the top of the frame instead of the bottom; see FramePacer.
+    void setLateLatch(bool enabled) { lateLatch = enabled; }
+    // Apples kept out at once (1 is the normal game, up to FruitSystem::CAPACITY / 2).
+    void setFruitCount(int count) { fruitCount = count; }
 
 private:
     // Game states
@@ -29,75 +72,140 @@ private:
     GameState state;
 
     // Background scrolling
-    std::vector<SDL_Texture*> bgLayers;
+    std::vector<TextureHandle> bgLayers;
     std::vector<int> bgTileW, bgTileH;
     std::vector<float> bgOffsets;
     std::vector<float> bgSpeeds;
 
     void handleEvents();
     void update();
+    // One fixed simulation step of frameDelay ms with the given keys.
+    void tick(const Uint8* keystate);
     void render();
     void clean();
     void reset();
     void updateVolumeDisplay(); // new method to update volume display
     void pauseMusic(); // new method to pause music
     void resumeMusic(); // new method to resume music
+    void updateSkinDisplay();
+    // Clicks through whatever screen is up when autoplay is on.
+    void driveAutoplayMenus();
+    const std::vector<Uint16>* reachableAppleSpawns() const;
+    // Milliseconds on the clock gameplay timers use: wall time normally, simulated
+    // ticks in deterministic mode.
+    Uint32 gameClock() const { return deterministic ? simTimeMs : SDL_GetTicks(); }
+    Uint64 stateChecksum() const;
 
     SDL_Window* window;
     SDL_Renderer* renderer;
     bool isRunning;
     const Uint32 appleTimeout = 8000;
 
+    std::string levelPath;
+    // Session RNG for gameplay randomness (spawns); the seed is logged at startup.
+    Rng rng;
+    Uint64 rngSeed;
+    bool seedRequested;
     Map map;
+    DynamicTiles dynamicTiles;
+    Hazards hazards;
+    // Standing spots and jump routes for the loaded level; lastPlayerNode is
+    // where the player last stood, used to keep apples reachable in time.
+    ReachGraph reach;
+    int lastPlayerNode;
+    // Sprite entities (the player); holds their positions, clips and draw order.
+    World world;
     Player player;
-    Apple apple;
+    FruitSystem fruits;
+    int fruitCount;
+    std::vector<FruitSystem::Collected> collected;
+    ParticleSystem particles;
+
+    // Broadphase for everything that moves or can be touched.
+    SpatialHash collisionHash;
+    int playerBody;
+    std::vector<int> contacts;
+
+    bool deterministic;
+    Uint32 simTimeMs;
+    Uint32 simTicks;
+    Uint64 lastChecksum;
+    std::string checksumPath;
+    FILE* checksumLog;
+
+    BotSwarm bots;
+    int botCount;
+    int botThreads;
+    bool botRender;
+
+    AutoPlayer autoPlayer;
+    bool autoplay;
+    GameState autoplayState;
+    Uint32 autoplayStateFrames;   // frames spent on the current screen
+    SoakLog soakLog;
+    std::string soakPath;
+    Uint32 soakIntervalMs;
 
     Uint32 frameStart;
+    Uint32 lastFrameStart;
+    Uint32 frameDeltaMs;
+    // Simulation time the frames have covered but no tick has run for yet.
+    Uint32 tickAccumulatorMs;
+    static const int MAX_TICKS_PER_FRAME = 6;
+    InputBuffer inputBuffer;
+    LatencyStats latency;
+    FramePacer pacer;
+    bool lateLatch;
+    int jumpBufferMs;
+    int coyoteMs;
     int frameTime;
     const int frameDelay = 1000 / 60;
 
     //score and high score
     int score;
     int highScore;
-    TTF_Font* font;
-    TTF_Font* menuFont;
-    TTF_Font* gameOverFont;
-    SDL_Texture* scoreTexture;
-    SDL_Texture* highScoreTexture;
-    SDL_Texture* timerTexture;
-    SDL_Texture* gameOverTexture;
-    SDL_Texture* restartTexture;
-    SDL_Rect scoreRect;
-    SDL_Rect highScoreRect;
-    SDL_Rect timerRect;
-    SDL_Rect gameOverRect;
-    SDL_Rect restartRect;
+    // Menus and HUD; the ids below index its widgets, and ACTION_* are what its hit test reports.
+    UiLayer ui;
+    enum UiAction {
+        ACTION_PLAY,
+        ACTION_SETTINGS,
+        ACTION_NEXT_SKIN,
+        ACTION_BACK,
+        ACTION_VOLUME_UP,
+        ACTION_VOLUME_DOWN,
+        ACTION_RESTART,
+        ACTION_RESUME
+    };
+    int scoreLabel;
+    int highScoreLabel;
+    int timerLabel;
+    int restartButton;
 
     //  menu elements
-    SDL_Texture* playTexture;
-    SDL_Rect playRect;
-    SDL_Texture* settingsTexture;
-    SDL_Rect settingsRect;
+    int playButton;
+    int settingsButton;
+    int skinButton;
+    CharacterSkin menuSkin;
 
     // settings screen elements
-    SDL_Texture* backTexture;
-    SDL_Rect backRect;
-    SDL_Texture* volumeUpTexture;
-    SDL_Rect volumeUpRect;
-    SDL_Texture* volumeDownTexture;
-    SDL_Rect volumeDownRect;
-    SDL_Texture* volumeDisplayTexture; // new texture for volume display
-    SDL_Rect volumeDisplayRect; // new rect for volume display
+    int backButton;
+    int volumeUpButton;
+    int volumeDownButton;
+    int volumeLabel;
     int musicVolume;
 
     // pause elements
-    SDL_Texture* pauseTexture;
-    SDL_Texture* resumeTexture;
-    SDL_Rect pauseRect;
-    SDL_Rect resumeRect;
+    int resumeButton;
 
     Mix_Music* backgroundMusic;
 
+    // frame capture (attract-mode recordings / hitch debugging)
+    FrameCapture frameCapture;
+    bool captureRequested;
+    FrameCapture::Format captureFormat;
+    std::string capturePath;
+    int captureEveryNthFrame;
+
     void updateScoreDisplay();
     void updateTimerDisplay(Uint32 remainingTime);
     void loadHighScore();
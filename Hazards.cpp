@@ -0,0 +1,361 @@
+#include "Hazards.h"
+#include "Constants.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+enum Motion : Uint8 { MOTION_NONE, MOTION_PATROL, MOTION_SWING, MOTION_SLAM };
+
+struct TypeInfo {
+    const char* entity;     // level entity type
+    AnimClipId clip;
+    int scale;
+    Motion motion;
+    Sint32 defaultParam;    // period in ms for moving types, lift for fans
+    int hitInset;           // pixels trimmed off the drawn sprite for the hit shape
+    bool round;             // hit shape is the circle inside the sprite
+    bool lethal;
+};
+
+const TypeInfo TYPE_INFO[] = {
+    { "Saw",        ANIM_SAW,         2, MOTION_PATROL, 3000, 4,  true,  true  },
+    { "SpikedBall", ANIM_SPIKED_BALL, 2, MOTION_SWING,  2400, 4,  true,  true  },
+    { "SpikeHead",  ANIM_SPIKE_HEAD,  2, MOTION_SLAM,   2500, 10, false, true  },
+    { "Spikes",     ANIM_SPIKES,      4, MOTION_NONE,   0,    8,  false, true  },
+    { "Fan",        ANIM_FAN,         4, MOTION_NONE,   11,   0,  false, false },
+};
+
+// sin and cos * 1024 of 0..60 degrees in 16 steps; the ball swings +-60 degrees.
+const Sint32 SWING_SIN[17] = { 0, 67, 134, 200, 265, 329, 392, 453, 512, 569, 623, 675, 724, 770, 812, 851, 887 };
+const Sint32 SWING_COS[17] = { 1024, 1022, 1015, 1004, 989, 970, 946, 918, 887, 851, 812, 770, 724, 675, 623, 569, 512 };
+const int SWING_STEPS = 16;
+// Distance between chain links, in pixels.
+const int CHAIN_SPACING = 16;
+
+// One full cycle is 65536 units of u.
+const Sint64 CYCLE = 65536;
+
+// 0 -> 1 -> 0 over the cycle.
+Sint64 triangle(Sint64 u) {
+    return u < CYCLE / 2 ? u * 2 : (CYCLE - u) * 2;
+}
+
+Sint32 swingSin(int step) { return step < 0 ? -SWING_SIN[-step] : SWING_SIN[step]; }
+Sint32 swingCos(int step) { return SWING_COS[step < 0 ? -step : step]; }
+
+int bodyData(int type, int index) { return (type << 16) | index; }
+
+} // namespace
+
+const int Hazards::POOL_CAPACITY;
+
+Hazards::Hazards() :
+    elapsedMs(0)
+{
+    for (int t = 0; t < TYPE_COUNT; ++t) {
+        pools[t].count = 0;
+        pools[t].spriteW = pools[t].spriteH = 0;
+    }
+}
+
+void Hazards::add(Type type, Sint32 originX, Sint32 originY, Sint32 rangeX, Sint32 rangeY, Uint32 periodMs, Sint32 param) {
+    Pool& pool = pools[type];
+    if (pool.count >= POOL_CAPACITY) {
+        if (pool.count == POOL_CAPACITY) {
+            printf("Hazards: more than %d %s entities, ignoring the rest\n", POOL_CAPACITY, TYPE_INFO[type].entity);
+            ++pool.count;  // report once
+        }
+        return;
+    }
+    int i = pool.count++;
+    pool.originX[i] = originX;
+    pool.originY[i] = originY;
+    pool.rangeX[i] = rangeX;
+    pool.rangeY[i] = rangeY;
+    pool.periodMs[i] = periodMs > 0 ? periodMs : 1;
+    pool.param[i] = param;
+    pool.body[i] = -1;
+}
+
+void Hazards::init(Map& map, SpatialHash& hash) {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    elapsedMs = 0;
+    for (int t = 0; t < TYPE_COUNT; ++t) {
+        Pool& pool = pools[t];
+        for (int i = 0; i < pool.count && i < POOL_CAPACITY; ++i) {
+            if (pool.body[i] >= 0) hash.remove(pool.body[i]);
+        }
+        pool.count = 0;
+        const AnimClip& clip = AnimationLibrary::get(TYPE_INFO[t].clip);
+        pool.spriteW = clip.frameW * TYPE_INFO[t].scale;
+        pool.spriteH = clip.frameH * TYPE_INFO[t].scale;
+        pool.anim = AnimState();
+        pool.anim.clip = TYPE_INFO[t].clip;
+    }
+
+    const LevelEntity* entities = map.getEntities();
+    for (int e = 0; e < map.getEntityCount(); ++e) {
+        const LevelEntity& entity = entities[e];
+        int type = -1;
+        for (int t = 0; t < TYPE_COUNT; ++t) {
+            if (strcmp(entity.type, TYPE_INFO[t].entity) == 0) { type = t; break; }
+        }
+        if (type < 0) continue;
+
+        const Pool& pool = pools[type];
+        Sint32 param = entity.param > 0 ? entity.param : TYPE_INFO[type].defaultParam;
+        Uint32 period = static_cast<Uint32>(param);
+        switch (static_cast<Type>(type)) {
+        case TYPE_SAW:
+            // Runs along the longer side, centred across the other.
+            if (entity.w >= entity.h) {
+                add(TYPE_SAW, entity.x, entity.y + (entity.h - pool.spriteH) / 2, entity.w - pool.spriteW, 0, period, 0);
+            }
+            else {
+                add(TYPE_SAW, entity.x + (entity.w - pool.spriteW) / 2, entity.y, 0, entity.h - pool.spriteH, period, 0);
+            }
+            break;
+        case TYPE_SPIKED_BALL:
+            // Anchor at the top centre; the chain reaches the ball's centre.
+            add(TYPE_SPIKED_BALL, entity.x + entity.w / 2, entity.y, 0, entity.h - pool.spriteH / 2, period, 0);
+            break;
+        case TYPE_SPIKE_HEAD:
+            add(TYPE_SPIKE_HEAD, entity.x + (entity.w - pool.spriteW) / 2, entity.y, 0, entity.h - pool.spriteH, period, 0);
+            break;
+        case TYPE_SPIKES:
+            for (int x = entity.x; x + tilePixelW <= entity.x + entity.w; x += tilePixelW) {
+                add(TYPE_SPIKES, x, entity.y + entity.h - pool.spriteH, 0, 0, 0, 0);
+            }
+            break;
+        case TYPE_FAN:
+            // The area is the air column; the fan itself sits centred on its floor.
+            add(TYPE_FAN, entity.x, entity.y, entity.w, entity.h, 0, param);
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (int t = 0; t < TYPE_COUNT; ++t) {
+        Pool& pool = pools[t];
+        if (pool.count > POOL_CAPACITY) pool.count = POOL_CAPACITY;
+        for (int i = 0; i < pool.count; ++i) {
+            place(static_cast<Type>(t), i);
+            pool.body[i] = hash.insert(hitBox(static_cast<Type>(t), i), SpatialHash::LAYER_HAZARD, bodyData(t, i));
+            if (TYPE_INFO[t].lethal) map.blockArea(sweptBox(static_cast<Type>(t), i));
+        }
+    }
+    checkSpawns(map);
+    if (getHazardCount() > 0) {
+        printf("Hazards: %d saws, %d spiked balls, %d spike heads, %d spikes, %d fans\n",
+               pools[TYPE_SAW].count, pools[TYPE_SPIKED_BALL].count, pools[TYPE_SPIKE_HEAD].count,
+               pools[TYPE_SPIKES].count, pools[TYPE_FAN].count);
+    }
+}
+
+int Hazards::checkSpawns(const Map& map) const {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+    const std::vector<SpawnPoint>& spawnPoints = map.getCollectibleSpawns();
+    const std::vector<Uint16>& active = map.getActiveSpawns();
+    int overlaps = 0;
+    for (size_t a = 0; a < active.size(); ++a) {
+        const SpawnPoint& point = spawnPoints[active[a]];
+        SDL_Rect spawn = { point.x, point.y, tilePixelW, tilePixelH };
+        for (int t = 0; t < TYPE_COUNT; ++t) {
+            if (!TYPE_INFO[t].lethal) continue;
+            for (int i = 0; i < pools[t].count; ++i) {
+                SDL_Rect swept = sweptBox(static_cast<Type>(t), i);
+                if (SDL_HasIntersection(&spawn, &swept)) {
+                    printf("Hazards: spawn %d at (%d, %d) overlaps %s %d\n", active[a], point.x, point.y, TYPE_INFO[t].entity, i);
+                    ++overlaps;
+                }
+            }
+        }
+    }
+    return overlaps;
+}
+
+int Hazards::getHazardCount() const {
+    int total = 0;
+    for (int t = 0; t < TYPE_COUNT; ++t) total += pools[t].count;
+    return total;
+}
+
+void Hazards::place(Type type, int i) {
+    Pool& pool = pools[type];
+    const Motion motion = TYPE_INFO[type].motion;
+    if (motion == MOTION_NONE) {
+        if (type == TYPE_FAN) {
+            pool.x[i] = pool.originX[i] + (pool.rangeX[i] - pool.spriteW) / 2;
+            pool.y[i] = pool.originY[i] + pool.rangeY[i] - pool.spriteH;
+        }
+        else {
+            pool.x[i] = pool.originX[i];
+            pool.y[i] = pool.originY[i];
+        }
+        return;
+    }
+
+    Sint64 u = static_cast<Sint64>(elapsedMs % pool.periodMs[i]) * CYCLE / pool.periodMs[i];
+    if (motion == MOTION_PATROL) {
+        Sint64 d = triangle(u);
+        pool.x[i] = pool.originX[i] + static_cast<Sint32>(pool.rangeX[i] * d / CYCLE);
+        pool.y[i] = pool.originY[i] + static_cast<Sint32>(pool.rangeY[i] * d / CYCLE);
+    }
+    else if (motion == MOTION_SWING) {
+        // Eased so the ball slows at both ends, then looked up in the swing table.
+        Sint64 d = triangle(u);
+        Sint64 eased = d * d / CYCLE * (3 * CYCLE - 2 * d) / CYCLE;
+        Sint64 at = eased * (2 * SWING_STEPS);
+        int step = static_cast<int>(at / CYCLE) - SWING_STEPS;
+        Sint64 frac = at % CYCLE;
+        int next = step < SWING_STEPS ? step + 1 : step;
+        Sint64 sinv = swingSin(step) + (swingSin(next) - swingSin(step)) * frac / CYCLE;
+        Sint64 cosv = swingCos(step) + (swingCos(next) - swingCos(step)) * frac / CYCLE;
+        Sint32 length = pool.rangeY[i];
+        pool.x[i] = pool.originX[i] + static_cast<Sint32>(length * sinv / 1024) - pool.spriteW / 2;
+        pool.y[i] = pool.originY[i] + static_cast<Sint32>(length * cosv / 1024) - pool.spriteH / 2;
+    }
+    else {
+        // Slam: fall with gravity for the first 20%, rest, rise slowly, rest at the top.
+        Sint64 d;
+        if (u < CYCLE / 5) {
+            Sint64 t = u * 5;
+            d = t * t / CYCLE;
+        }
+        else if (u < CYCLE * 2 / 5) {
+            d = CYCLE;
+        }
+        else if (u < CYCLE * 9 / 10) {
+            d = CYCLE - (u - CYCLE * 2 / 5) * 2;
+        }
+        else {
+            d = 0;
+        }
+        pool.x[i] = pool.originX[i] + static_cast<Sint32>(pool.rangeX[i] * d / CYCLE);
+        pool.y[i] = pool.originY[i] + static_cast<Sint32>(pool.rangeY[i] * d / CYCLE);
+    }
+}
+
+SDL_Rect Hazards::hitBox(Type type, int i) const {
+    const Pool& pool = pools[type];
+    const int inset = TYPE_INFO[type].hitInset;
+    if (type == TYPE_FAN) {
+        SDL_Rect column = { pool.originX[i], pool.originY[i], pool.rangeX[i], pool.rangeY[i] - pool.spriteH };
+        return column;
+    }
+    if (type == TYPE_SPIKES) {
+        // Only the points along the bottom half of the tile hurt.
+        SDL_Rect points = { pool.x[i] + inset, pool.y[i] + pool.spriteH / 2, pool.spriteW - 2 * inset, pool.spriteH / 2 };
+        return points;
+    }
+    if (TYPE_INFO[type].round) {
+        int radius = pool.spriteW / 2 - inset;
+        SDL_Rect bounds = { pool.x[i] + pool.spriteW / 2 - radius, pool.y[i] + pool.spriteH / 2 - radius, 2 * radius, 2 * radius };
+        return bounds;
+    }
+    SDL_Rect box = { pool.x[i] + inset, pool.y[i] + inset, pool.spriteW - 2 * inset, pool.spriteH - 2 * inset };
+    return box;
+}
+
+SDL_Rect Hazards::sweptBox(Type type, int i) const {
+    const Pool& pool = pools[type];
+    SDL_Rect box = hitBox(type, i);
+    if (TYPE_INFO[type].motion == MOTION_SWING) {
+        // Centred on the ball: +-60 degrees across, from half the chain down to all of it.
+        Sint32 length = pool.rangeY[i];
+        Sint32 reachX = length * SWING_SIN[SWING_STEPS] / 1024;
+        Sint32 topY = length * SWING_COS[SWING_STEPS] / 1024;
+        SDL_Rect arc = { pool.originX[i] - reachX - box.w / 2, pool.originY[i] + topY - box.h / 2,
+                         2 * reachX + box.w, length - topY + box.h };
+        return arc;
+    }
+    // Patrols and slams run from their origin, where the box sits now, across the range.
+    box.x += pool.originX[i] - pool.x[i];
+    box.y += pool.originY[i] - pool.y[i];
+    box.w += pool.rangeX[i];
+    box.h += pool.rangeY[i];
+    return box;
+}
+
+void Hazards::update(SpatialHash& hash, Uint32 dtMs) {
+    elapsedMs += dtMs;
+    for (int t = 0; t < TYPE_COUNT; ++t) {
+        Pool& pool = pools[t];
+        if (pool.count == 0) continue;
+        AnimationLibrary::advance(pool.anim, dtMs);
+        if (TYPE_INFO[t].motion == MOTION_NONE) continue;
+        for (int i = 0; i < pool.count; ++i) {
+            place(static_cast<Type>(t), i);
+            hash.update(pool.body[i], hitBox(static_cast<Type>(t), i));
+        }
+    }
+}
+
+void Hazards::reset(SpatialHash& hash) {
+    elapsedMs = 0;
+    update(hash, 0);
+}
+
+Hazards::Touch Hazards::touch(const SpatialHash& hash, const std::vector<int>& bodies, const SDL_Rect& player) const {
+    Touch result;
+    for (size_t b = 0; b < bodies.size(); ++b) {
+        if (hash.getLayer(bodies[b]) != SpatialHash::LAYER_HAZARD) continue;
+        int data = hash.getUserData(bodies[b]);
+        Type type = static_cast<Type>(data >> 16);
+        int i = data & 0xFFFF;
+
+        if (TYPE_INFO[type].round) {
+            // Circle against box: distance from the centre to the nearest point of the box.
+            SDL_Rect bounds = hitBox(type, i);
+            Sint32 radius = bounds.w / 2;
+            Sint32 cx = bounds.x + radius, cy = bounds.y + radius;
+            Sint32 nx = cx < player.x ? player.x : (cx > player.x + player.w ? player.x + player.w : cx);
+            Sint32 ny = cy < player.y ? player.y : (cy > player.y + player.h ? player.y + player.h : cy);
+            Sint32 dx = cx - nx, dy = cy - ny;
+            if (dx * dx + dy * dy >= radius * radius) continue;
+        }
+        // Box shapes already overlap: the broad phase box is the hit box.
+        if (TYPE_INFO[type].lethal) result.lethal = true;
+        if (type == TYPE_FAN && pools[type].param[i] > result.lift) result.lift = pools[type].param[i];
+    }
+    return result;
+}
+
+void Hazards::render(SDL_Renderer* renderer) {
+    for (int t = 0; t < TYPE_COUNT; ++t) {
+        const Pool& pool = pools[t];
+        if (pool.count == 0) continue;
+        SDL_Texture* texture = TextureManager::get(AnimationLibrary::get(pool.anim.clip).texture);
+        if (!texture) continue;
+        SDL_Rect src = AnimationLibrary::frameRect(pool.anim);
+
+        if (t == TYPE_SPIKED_BALL) {
+            const AnimClip& chain = AnimationLibrary::get(ANIM_SPIKED_BALL_CHAIN);
+            SDL_Texture* chainTexture = TextureManager::get(chain.texture);
+            if (chainTexture) {
+                AnimState link;
+                link.clip = ANIM_SPIKED_BALL_CHAIN;
+                SDL_Rect linkSrc = AnimationLibrary::frameRect(link);
+                int linkW = chain.frameW * TYPE_INFO[t].scale, linkH = chain.frameH * TYPE_INFO[t].scale;
+                for (int i = 0; i < pool.count; ++i) {
+                    int dx = pool.x[i] + pool.spriteW / 2 - pool.originX[i];
+                    int dy = pool.y[i] + pool.spriteH / 2 - pool.originY[i];
+                    int links = pool.rangeY[i] / CHAIN_SPACING;
+                    for (int k = 0; k < links; ++k) {
+                        SDL_Rect dst = { pool.originX[i] + dx * k / links - linkW / 2,
+                                         pool.originY[i] + dy * k / links - linkH / 2, linkW, linkH };
+                        SDL_RenderCopy(renderer, chainTexture, &linkSrc, &dst);
+                    }
+                }
+            }
+        }
+
+        for (int i = 0; i < pool.count; ++i) {
+            SDL_Rect dst = { pool.x[i], pool.y[i], pool.spriteW, pool.spriteH };
+            SDL_RenderCopy(renderer, texture, &src, &dst);
+        }
+    }
+}
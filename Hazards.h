@@ -0,0 +1,77 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "Map.h"
+#include "Animation.h"
+#include "SpatialHash.h"
+
+// Traps built from level entities, x y w h giving the area each one works in:
+//   Saw x y w h [periodMs]         runs end to end along the longer side of the area
+//   SpikedBall x y w h [periodMs]  swings on a chain from the top centre, h long
+//   SpikeHead x y w h [periodMs]   slams from the top of the area to the bottom, then rises
+//   Spikes x y w h                 a row of spikes, one per tile along the bottom of the area
+//   Fan x y w h [lift]             blows the player up the area at lift px per tick
+// Each type keeps its hazards in a fixed-capacity pool of flat arrays and shares
+// one animation, so a frame costs the same for every hazard and allocates nothing.
+// Motion is integer-only, so deterministic runs see the same positions everywhere.
+class Hazards {
+public:
+    static const int POOL_CAPACITY = 256;   // per type
+
+    struct Touch {
+        bool lethal = false;
+        int lift = 0;       // strongest fan under the player, px per tick
+    };
+
+    Hazards();
+
+    // Fills the pools from the map's entities and files every hazard in 'hash'
+    // under SpatialHash::LAYER_HAZARD. Cells a lethal hazard can reach are blocked
+    // on the map, so run this before anything reads its spawns or standing spots.
+    void init(Map& map, SpatialHash& hash);
+    void update(SpatialHash& hash, Uint32 dtMs);
+    void render(SDL_Renderer* renderer);
+    // Puts every hazard back at the start of its cycle.
+    void reset(SpatialHash& hash);
+
+    // Narrow phase for the LAYER_HAZARD bodies a query returned for 'player'.
+    Touch touch(const SpatialHash& hash, const std::vector<int>& bodies, const SDL_Rect& player) const;
+
+    int getHazardCount() const;
+
+private:
+    enum Type : Uint8 {
+        TYPE_SAW,
+        TYPE_SPIKED_BALL,
+        TYPE_SPIKE_HEAD,
+        TYPE_SPIKES,
+        TYPE_FAN,
+        TYPE_COUNT
+    };
+
+    struct Pool {
+        int count;
+        int spriteW, spriteH;   // drawn size, the same for every hazard of the type
+        // Path: patrol start and travel, swing anchor and chain length (in rangeY),
+        // or the fixed spot for static types.
+        Sint32 originX[POOL_CAPACITY], originY[POOL_CAPACITY];
+        Sint32 rangeX[POOL_CAPACITY], rangeY[POOL_CAPACITY];
+        Uint32 periodMs[POOL_CAPACITY];
+        Sint32 param[POOL_CAPACITY];
+        // Current sprite top-left, and the collision body filed for it.
+        Sint32 x[POOL_CAPACITY], y[POOL_CAPACITY];
+        int body[POOL_CAPACITY];
+        AnimState anim;
+    };
+
+    void add(Type type, Sint32 originX, Sint32 originY, Sint32 rangeX, Sint32 rangeY, Uint32 periodMs, Sint32 param);
+    void place(Type type, int index);
+    SDL_Rect hitBox(Type type, int index) const;
+    // Everything the hit shape covers over a whole cycle.
+    SDL_Rect sweptBox(Type type, int index) const;
+    // Reports any active spawn a lethal hazard can reach; returns how many there are.
+    int checkSpawns(const Map& map) const;
+
+    Pool pools[TYPE_COUNT];
+    Uint32 elapsedMs;
+};
@@ -0,0 +1,39 @@
+#include "InputBuffer.h"
+#include <cstring>
+
+InputBuffer::InputBuffer() :
+    head(0)
+{
+    memset(held, 0, sizeof(held));
+    memset(keys, 0, sizeof(keys));
+    events.reserve(64);
+    sampled.reserve(16);
+}
+
+void InputBuffer::push(const SDL_KeyboardEvent& key) {
+    if (key.repeat) return;
+    SDL_Scancode scancode = key.keysym.scancode;
+    if (scancode <= SDL_SCANCODE_UNKNOWN || scancode >= SDL_NUM_SCANCODES) return;
+    KeyEvent event;
+    event.timestamp = key.timestamp;
+    event.scancode = static_cast<Uint16>(scancode);
+    event.down = key.state == SDL_PRESSED ? 1 : 0;
+    events.push_back(event);
+}
+
+const Uint8* InputBuffer::sample(Uint32 untilMs) {
+    memcpy(keys, held, sizeof(keys));
+    sampled.clear();
+    // Events arrive in timestamp order; stop at the first one past this tick.
+    while (head < events.size() && static_cast<Sint32>(events[head].timestamp - untilMs) <= 0) {
+        const KeyEvent& event = events[head++];
+        held[event.scancode] = event.down;
+        sampled.push_back(event.timestamp);
+        if (event.down) keys[event.scancode] = 1;
+    }
+    if (head == events.size()) {
+        events.clear();
+        head = 0;
+    }
+    return keys;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Keyboard events queued with their SDL timestamps and replayed tick by tick,
+// so each key change lands on the simulation tick it happened in rather than
+// on whichever frame polled it. A key pressed and released inside one tick
+// still reads as held for that tick, so short taps are never lost.
+class InputBuffer {
+public:
+    InputBuffer();
+
+    // Queues a key change; auto-repeat events are ignored.
+    void push(const SDL_KeyboardEvent& key);
+    // Key state for the tick ending at untilMs (SDL_GetTicks() time): applies every
+    // event stamped up to then and returns the keys held at any point of the tick.
+    const Uint8* sample(Uint32 untilMs);
+
+    // Timestamps of the events the last sample() applied.
+    const std::vector<Uint32>& getSampledEvents() const { return sampled; }
+    int getQueuedCount() const { return static_cast<int>(events.size() - head); }
+
+private:
+    struct KeyEvent {
+        Uint32 timestamp;
+        Uint16 scancode;
+        Uint8 down;
+    };
+
+    std::vector<KeyEvent> events;   // unread from 'head' on, in arrival order
+    size_t head;
+    std::vector<Uint32> sampled;
+    Uint8 held[SDL_NUM_SCANCODES];
+    Uint8 keys[SDL_NUM_SCANCODES];
+};
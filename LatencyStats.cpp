@@ -0,0 +1,101 @@
+#include "LatencyStats.h"
+#include <cstdio>
+#include <cstring>
+
+const Uint32 LatencyStats::REPORT_MS;
+const int LatencyStats::HISTOGRAM_BUCKETS;
+
+void LatencyStats::Stage::reset() {
+    count = 0;
+    sumMs = 0;
+    maxMs = 0;
+    memset(histogram, 0, sizeof(histogram));
+}
+
+void LatencyStats::Stage::add(Uint32 ms) {
+    ++count;
+    sumMs += ms;
+    if (ms > maxMs) maxMs = ms;
+    ++histogram[ms < static_cast<Uint32>(HISTOGRAM_BUCKETS) ? ms : HISTOGRAM_BUCKETS - 1];
+}
+
+Uint32 LatencyStats::Stage::percentile(int pct) const {
+    if (count == 0) return 0;
+    Uint32 target = (count * static_cast<Uint64>(pct) + 99) / 100;
+    Uint32 seen = 0;
+    for (int ms = 0; ms < HISTOGRAM_BUCKETS; ++ms) {
+        seen += histogram[ms];
+        if (seen >= target) return ms;
+    }
+    return HISTOGRAM_BUCKETS - 1;
+}
+
+LatencyStats::LatencyStats() :
+    enabled(false),
+    windowStart(0)
+{
+    total.reset();
+    queued.reset();
+    window.reset();
+    pending.reserve(32);
+}
+
+void LatencyStats::consumed(Uint32 eventMs, Uint32 tickMs) {
+    if (!enabled) return;
+    Pending p;
+    p.eventMs = eventMs;
+    p.tickMs = tickMs;
+    pending.push_back(p);
+}
+
+void LatencyStats::presented(Uint32 presentMs) {
+    if (!enabled) return;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        // Events can be stamped a hair after the tick that sampled them started.
+        Uint32 queueMs = static_cast<Sint32>(pending[i].tickMs - pending[i].eventMs) > 0 ? pending[i].tickMs - pending[i].eventMs : 0;
+        Uint32 totalMs = static_cast<Sint32>(presentMs - pending[i].eventMs) > 0 ? presentMs - pending[i].eventMs : 0;
+        queued.add(queueMs);
+        total.add(totalMs);
+        window.add(totalMs);
+    }
+    pending.clear();
+    if (windowStart == 0) windowStart = presentMs;
+    if (presentMs - windowStart >= REPORT_MS) printLive(presentMs);
+}
+
+void LatencyStats::printLive(Uint32 now) {
+    if (window.count > 0) {
+        printf("Latency: %u inputs, avg %.1f ms, p50 %u ms, p99 %u ms, max %u ms\n",
+               window.count, window.average(), window.percentile(50), window.percentile(99), window.maxMs);
+    }
+    window.reset();
+    windowStart = now;
+}
+
+void LatencyStats::printReport() const {
+    if (!enabled) return;
+    if (total.count == 0) {
+        printf("Latency: no key inputs measured.\n");
+        return;
+    }
+    printf("Input-to-present latency over %u inputs: avg %.1f ms, p50 %u ms, p90 %u ms, p99 %u ms, max %u ms\n",
+           total.count, total.average(), total.percentile(50), total.percentile(90), total.percentile(99), total.maxMs);
+    printf("  of which waiting for a tick: avg %.1f ms, p99 %u ms, max %u ms\n",
+           queued.average(), queued.percentile(99), queued.maxMs);
+
+    Uint32 peak = 0;
+    int first = -1, last = 0;
+    for (int ms = 0; ms < HISTOGRAM_BUCKETS; ++ms) {
+        if (total.histogram[ms] > peak) peak = total.histogram[ms];
+        if (!total.histogram[ms]) continue;
+        if (first < 0) first = ms;
+        last = ms;
+    }
+    const int barWidth = 50;
+    for (int ms = first; ms <= last; ++ms) {
+        int bar = static_cast<int>(static_cast<Uint64>(total.histogram[ms]) * barWidth / peak);
+        if (total.histogram[ms] && bar == 0) bar = 1;
+        printf("  %3d%s ms %6u |%.*s\n", ms, ms == HISTOGRAM_BUCKETS - 1 ? "+" : " ", total.histogram[ms], bar,
+               "##################################################");
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Input-to-photon latency (--latency-stats). Every key change is followed from
+// its SDL event timestamp, through the tick whose Player::handleInput consumed
+// it, to the SDL_RenderPresent that first showed that tick. A summary line is
+// printed every REPORT_MS while inputs arrive, and a histogram at exit.
+// Event timestamps come from SDL_GetTicks(), so everything is in whole ms.
+class LatencyStats {
+public:
+    LatencyStats();
+
+    void setEnabled(bool on) { enabled = on; }
+    bool isEnabled() const { return enabled; }
+
+    // The tick running at tickMs consumed a key event stamped eventMs.
+    void consumed(Uint32 eventMs, Uint32 tickMs);
+    // A frame holding every tick consumed so far was presented at presentMs.
+    void presented(Uint32 presentMs);
+
+    // Histogram of everything measured so far; printed by Game::clean.
+    void printReport() const;
+
+private:
+    static const Uint32 REPORT_MS = 5000;
+    static const int HISTOGRAM_BUCKETS = 256;
+
+    struct Stage {
+        Uint32 count;
+        Uint64 sumMs;
+        Uint32 maxMs;
+        Uint32 histogram[HISTOGRAM_BUCKETS];     // per ms; the last bucket collects everything slower
+
+        void reset();
+        void add(Uint32 ms);
+        Uint32 percentile(int pct) const;
+        double average() const { return count ? static_cast<double>(sumMs) / count : 0.0; }
+    };
+
+    struct Pending {
+        Uint32 eventMs;
+        Uint32 tickMs;
+    };
+
+    void printLive(Uint32 now);
+
+    bool enabled;
+    std::vector<Pending> pending;
+    Stage total;        // event to present
+    Stage queued;       // event to the tick that consumed it
+    Stage window;       // totals since the last live line
+    Uint32 windowStart;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <SDL.h>
+
+// On-disk level layout written by tools/level_import.py. The file is mapped and
+// read in place, so every record is fixed-size, naturally aligned and
+// little-endian; offsets are from the start of the file.
+//
+//   LevelHeader
+//   Uint16      tiles[rows * cols]     row-major tileset indices, 0 = empty; with
+//                                      LEVEL_TILE_AUTOTILE set, the index of a 3x3
+//                                      terrain block's top-left tile
+//   Uint64      solid[rows]            bit c set when column c is solid (8-byte aligned)
+//   LevelSpawn  spawns[spawnCount]
+//   LevelEntity entities[entityCount]
+
+const Uint32 LEVEL_MAGIC = 0x4C56454C;  // "LEVL"
+const Uint16 LEVEL_VERSION = 2;
+const int LEVEL_MAX_COLS = 64;          // one Uint64 collision mask per row
+const Uint16 LEVEL_TILE_AUTOTILE = 0x8000;
+
+struct LevelHeader {
+    Uint32 magic;
+    Uint16 version;
+    Uint16 headerSize;
+    Uint32 fileSize;
+    Uint16 rows, cols;
+    Uint16 tileW, tileH;       // source tile size in the tileset, in pixels
+    char tileset[64];          // asset path, NUL-terminated
+    Uint32 tilesOffset;
+    Uint32 solidOffset;
+    Uint32 spawnOffset, spawnCount;
+    Uint32 entityOffset, entityCount;
+};
+
+enum LevelSpawnKind : Uint16 {
+    LEVEL_SPAWN_PLAYER,
+    LEVEL_SPAWN_COLLECTIBLE
+};
+
+struct LevelSpawn {
+    Uint16 kind;
+    Uint16 reserved;
+    Sint32 x, y;               // pixels, top-left of the spawned body
+};
+
+struct LevelEntity {
+    char type[16];             // NUL-terminated type name, e.g. "Saw"
+    Sint32 x, y, w, h;         // pixels
+    Sint32 param;              // type-specific
+};
+
+static_assert(sizeof(LevelHeader) == 108, "LevelHeader must match tools/level_import.py");
+static_assert(sizeof(LevelSpawn) == 12, "LevelSpawn must match tools/level_import.py");
+static_assert(sizeof(LevelEntity) == 36, "LevelEntity must match tools/level_import.py");
@@ -1,66 +1,423 @@
 ﻿#include "Map.h"
 #include "TextureManager.h"
 #include <cstdio>
+#include <cmath>
+#include <cstring>
 
-Map::Map() : tileset(nullptr) {
-    for (int row = 0; row < MAP_ROWS; ++row) {
-        for (int col = 0; col < MAP_COLS; ++col) {
-            mapData[row][col] = 0;
+static const float SWEEP_SLACK = 1e-4f;
+// Free cells qualify as collectible spawns from this row down, when solid ground
+// lies within SPAWN_GROUND_REACH rows beneath them.
+static const int SPAWN_FIRST_ROW = 2;
+static const int SPAWN_GROUND_REACH = 9;
+
+Map::Map() :
+    tilesetCols(1),
+    header(nullptr),
+    tiles(nullptr),
+    solidRows(nullptr),
+    spawns(nullptr),
+    entities(nullptr),
+    rows(0),
+    cols(0),
+    baked(nullptr),
+    bakedBytes(0),
+    bakeRenderer(nullptr),
+    explicitSpawns(false),
+    spawnLastRow(-1),
+    spawnLastCol(-1)
+{
+}
+
+Map::~Map() {
+    shutdown();
+}
+
+void Map::shutdown() {
+    releaseBake();
+    TextureManager::release(tileset);
+}
+
+void Map::releaseBake() {
+    if (!baked) return;
+    SDL_DestroyTexture(baked);
+    baked = nullptr;
+    TextureManager::trackExternal(TEXTURE_CATEGORY_TILESET, bakedBytes, false);
+    bakedBytes = 0;
+}
+
+bool Map::init(const char* levelPath, SDL_Renderer* renderer) {
+    shutdown();
+    header = nullptr;
+    tiles = nullptr;
+    solidRows = nullptr;
+    spawns = nullptr;
+    entities = nullptr;
+    rows = cols = 0;
+    ownedTiles.clear();
+    ownedSolidRows.clear();
+    collectibleSpawns.clear();
+    activeSpawns.clear();
+    activeSlot.clear();
+    spawnOfCell.clear();
+    blockedRows.clear();
+    visuals.clear();
+
+    if (!file.open(levelPath) || !validate(levelPath)) {
+        file.close();
+        return false;
+    }
+
+    const unsigned char* base = file.data();
+    header = reinterpret_cast<const LevelHeader*>(base);
+    tiles = reinterpret_cast<const Uint16*>(base + header->tilesOffset);
+    solidRows = reinterpret_cast<const Uint64*>(base + header->solidOffset);
+    spawns = reinterpret_cast<const LevelSpawn*>(base + header->spawnOffset);
+    entities = reinterpret_cast<const LevelEntity*>(base + header->entityOffset);
+    rows = header->rows;
+    cols = header->cols;
+
+    AssetId tilesetAsset = findAsset(header->tileset);
+    tileset = TextureManager::acquire(tilesetAsset, renderer, TEXTURE_CATEGORY_TILESET);
+    if (!tileset.isValid()) {
+        printf("Failed to load tileset texture: %s\n", header->tileset);
+        return false;
+    }
+    tilesetCols = ASSET_MANIFEST[tilesetAsset].width / TILE_WIDTH;
+    if (tilesetCols < 1) tilesetCols = 1;
+    buildSpawnTable();
+
+    visuals.assign(static_cast<size_t>(rows) * cols, 0);
+    resolveVisuals(0, 0, rows - 1, cols - 1);
+    bake(renderer);
+
+    printf("Map loaded: %s (%dx%d tiles, %u spawns, %u entities, %d collectible cells, tileset %s)\n", levelPath,
+           cols, rows, header->spawnCount, header->entityCount, static_cast<int>(collectibleSpawns.size()), header->tileset);
+    return true;
+}
+
+bool Map::validate(const char* levelPath) const {
+    const size_t size = file.size();
+    if (size < sizeof(LevelHeader)) {
+        printf("Level '%s' is truncated\n", levelPath);
+        return false;
+    }
+    const LevelHeader& h = *reinterpret_cast<const LevelHeader*>(file.data());
+    if (h.magic != LEVEL_MAGIC || h.headerSize != sizeof(LevelHeader)) {
+        printf("Level '%s' is not a level file\n", levelPath);
+        return false;
+    }
+    if (h.version != LEVEL_VERSION) {
+        printf("Level '%s' has version %u, expected %u; re-run tools/level_import.py\n", levelPath,
+               h.version, LEVEL_VERSION);
+        return false;
+    }
+    if (h.fileSize != size || h.rows == 0 || h.cols == 0 || h.cols > LEVEL_MAX_COLS ||
+        h.tileW != TILE_WIDTH || h.tileH != TILE_HEIGHT || memchr(h.tileset, 0, sizeof(h.tileset)) == nullptr) {
+        printf("Level '%s' has an invalid header\n", levelPath);
+        return false;
+    }
+
+    // Every section must lie inside the file and be aligned for in-place access.
+    struct Section { Uint32 offset; size_t bytes; size_t align; };
+    const Section sections[] = {
+        { h.tilesOffset, static_cast<size_t>(h.rows) * h.cols * sizeof(Uint16), alignof(Uint16) },
+        { h.solidOffset, static_cast<size_t>(h.rows) * sizeof(Uint64), alignof(Uint64) },
+        { h.spawnOffset, static_cast<size_t>(h.spawnCount) * sizeof(LevelSpawn), alignof(LevelSpawn) },
+        { h.entityOffset, static_cast<size_t>(h.entityCount) * sizeof(LevelEntity), alignof(LevelEntity) }
+    };
+    for (const Section& section : sections) {
+        if (section.offset % section.align != 0 || section.offset > size || section.bytes > size - section.offset) {
+            printf("Level '%s' has a corrupt section table\n", levelPath);
+            return false;
         }
     }
+    if (findAsset(h.tileset) == INVALID_ASSET) {
+        printf("Level '%s' uses tileset '%s', which is not in the asset manifest\n", levelPath, h.tileset);
+        return false;
+    }
+    return true;
 }
 
-Map::~Map() {
-    // Textures are cleaned up by TextureManager::cleanUp()
+bool Map::getPlayerSpawn(float& x, float& y) const {
+    for (int i = 0; i < getSpawnCount(); ++i) {
+        if (spawns[i].kind == LEVEL_SPAWN_PLAYER) {
+            x = static_cast<float>(spawns[i].x);
+            y = static_cast<float>(spawns[i].y);
+            return true;
+        }
+    }
+    return false;
 }
 
-void Map::init(const char* tilesetPath, SDL_Renderer* renderer) {
-    tileset = TextureManager::loadTexture("assets/platforms.png", renderer);
-    if (!tileset) {
-        printf("Failed to load tileset texture: %s\n", tilesetPath);
+void Map::buildSpawnTable() {
+    collectibleSpawns.clear();
+    activeSpawns.clear();
+    activeSlot.clear();
+    spawnOfCell.assign(static_cast<size_t>(rows) * cols, -1);
+    blockedRows.assign(rows, 0);
+    for (int i = 0; i < getSpawnCount(); ++i) {
+        if (spawns[i].kind == LEVEL_SPAWN_COLLECTIBLE) {
+            SpawnPoint point = { static_cast<Sint16>(spawns[i].x), static_cast<Sint16>(spawns[i].y) };
+            collectibleSpawns.push_back(point);
+        }
+    }
+    explicitSpawns = !collectibleSpawns.empty();
+    if (explicitSpawns) {
+        for (size_t i = 0; i < collectibleSpawns.size(); ++i) {
+            activeSlot.push_back(static_cast<int>(activeSpawns.size()));
+            activeSpawns.push_back(static_cast<Uint16>(i));
+        }
         return;
     }
 
-    const int EMPTY_TILE = 0;
-    const int GOLD_BLOCK = (1 * TILESET_COLS) + 0;
-
-    int initialMap[MAP_ROWS][MAP_COLS] = {
-        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-        { GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, 0, 0, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, 0, 0, 0, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK },
-        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-        { 0, 0, 0, 0, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, 0, 0, 0, 0, 0, 0, 0, 0, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, 0, 0, 0, 0 },
-        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-        { GOLD_BLOCK, GOLD_BLOCK, 0, 0, 0, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, 0, 0, 0, 0, 0, GOLD_BLOCK, GOLD_BLOCK },
-        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-        { GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK },
-        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-        { GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK, GOLD_BLOCK }
-    };
+    // A cell qualifies when it is empty, fully on screen, below the top two rows
+    // and has solid ground somewhere in the SPAWN_GROUND_REACH rows beneath it.
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+    spawnLastCol = (WINDOW_WIDTH - tilePixelW) / tilePixelW;
+    spawnLastRow = (WINDOW_HEIGHT - tilePixelH) / tilePixelH;
+    if (spawnLastCol >= cols) spawnLastCol = cols - 1;
+    if (spawnLastRow >= rows) spawnLastRow = rows - 1;
+    const Uint64 onScreen = ~Uint64(0) >> (63 - spawnLastCol);
+
+    for (int row = SPAWN_FIRST_ROW; row <= spawnLastRow; ++row) {
+        Uint64 groundBelow = 0;
+        for (int below = row + 1; below < rows && below <= row + SPAWN_GROUND_REACH; ++below) {
+            groundBelow |= solidRows[below];
+        }
+        Uint64 cells = ~solidRows[row] & groundBelow & onScreen;
+        for (int col = 0; cells; ++col, cells >>= 1) {
+            if (cells & 1) {
+                int spawn = static_cast<int>(collectibleSpawns.size());
+                SpawnPoint point = { static_cast<Sint16>(col * tilePixelW), static_cast<Sint16>(row * tilePixelH) };
+                collectibleSpawns.push_back(point);
+                spawnOfCell[row * cols + col] = spawn;
+                activeSlot.push_back(static_cast<int>(activeSpawns.size()));
+                activeSpawns.push_back(static_cast<Uint16>(spawn));
+            }
+        }
+    }
+}
+
+bool Map::spawnCellQualifies(int row, int col) const {
+    if (row < SPAWN_FIRST_ROW || row > spawnLastRow || col > spawnLastCol) return false;
+    const Uint64 bit = Uint64(1) << col;
+    if ((solidRows[row] | blockedRows[row]) & bit) return false;
+    for (int below = row + 1; below < rows && below <= row + SPAWN_GROUND_REACH; ++below) {
+        if (solidRows[below] & bit) return true;
+    }
+    return false;
+}
+
+void Map::blockArea(const SDL_Rect& area) {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+    if (area.w <= 0 || area.h <= 0 || area.x + area.w <= 0 || area.y + area.h <= 0) return;
+    int col0 = area.x < 0 ? 0 : area.x / tilePixelW;
+    int row0 = area.y < 0 ? 0 : area.y / tilePixelH;
+    int col1 = (area.x + area.w - 1) / tilePixelW;
+    int row1 = (area.y + area.h - 1) / tilePixelH;
+    if (col1 >= cols) col1 = cols - 1;
+    if (row1 >= rows) row1 = rows - 1;
+    if (col0 > col1 || row0 > row1) return;
+    const Uint64 span = (~Uint64(0) >> (63 - col1)) & (~Uint64(0) << col0);
+    for (int row = row0; row <= row1; ++row) {
+        blockedRows[row] |= span;
+    }
+
+    // Explicit spawns sit anywhere, so test each one against the cells rather than
+    // looking it up by cell.
+    for (size_t i = 0; i < collectibleSpawns.size(); ++i) {
+        int col = collectibleSpawns[i].x / tilePixelW, row = collectibleSpawns[i].y / tilePixelH;
+        int colEnd = (collectibleSpawns[i].x + tilePixelW - 1) / tilePixelW;
+        int rowEnd = (collectibleSpawns[i].y + tilePixelH - 1) / tilePixelH;
+        if (colEnd >= col0 && col <= col1 && rowEnd >= row0 && row <= row1) {
+            setSpawnActive(static_cast<int>(i), false);
+        }
+    }
+}
+
+void Map::setSpawnActive(int spawn, bool isActive) {
+    int slot = activeSlot[spawn];
+    if (isActive == (slot >= 0)) return;
+    if (isActive) {
+        activeSlot[spawn] = static_cast<int>(activeSpawns.size());
+        activeSpawns.push_back(static_cast<Uint16>(spawn));
+        return;
+    }
+    // Swap-remove so deactivation stays O(1).
+    Uint16 moved = activeSpawns.back();
+    activeSpawns[slot] = moved;
+    activeSlot[moved] = slot;
+    activeSpawns.pop_back();
+    activeSlot[spawn] = -1;
+}
 
-    for (int row = 0; row < MAP_ROWS; ++row) {
-        for (int col = 0; col < MAP_COLS; ++col) {
-            mapData[row][col] = initialMap[row][col];
+void Map::updateSpawnColumn(int row, int col) {
+    if (explicitSpawns) return;
+    // A solid change only affects the cell itself and the ones it can be ground for.
+    int first = row - SPAWN_GROUND_REACH;
+    if (first < SPAWN_FIRST_ROW) first = SPAWN_FIRST_ROW;
+    for (int r = first; r <= row; ++r) {
+        bool qualifies = spawnCellQualifies(r, col);
+        int spawn = spawnOfCell[r * cols + col];
+        if (spawn < 0) {
+            if (!qualifies || collectibleSpawns.size() > 0xFFFF) continue;
+            spawn = static_cast<int>(collectibleSpawns.size());
+            SpawnPoint point = { static_cast<Sint16>(col * TILE_WIDTH * TILE_SCALE),
+                                 static_cast<Sint16>(r * TILE_HEIGHT * TILE_SCALE) };
+            collectibleSpawns.push_back(point);
+            activeSlot.push_back(-1);
+            spawnOfCell[r * cols + col] = spawn;
         }
+        setSpawnActive(spawn, qualifies);
     }
-    printf("Map initialized with tileset: %s\n", tilesetPath);
+}
+
+void Map::makeWritable() {
+    if (!ownedTiles.empty()) return;
+    ownedTiles.assign(tiles, tiles + static_cast<size_t>(rows) * cols);
+    ownedSolidRows.assign(solidRows, solidRows + rows);
+    tiles = ownedTiles.data();
+    solidRows = ownedSolidRows.data();
+}
+
+void Map::setTile(int row, int col, Uint16 tile) {
+    if (row < 0 || row >= rows || col < 0 || col >= cols || tiles[row * cols + col] == tile) return;
+    makeWritable();
+    bool wasSolid = tiles[row * cols + col] != 0;
+    ownedTiles[row * cols + col] = tile;
+    // Autotiled neighbours pick their variant from this cell, so they redraw too.
+    refreshRegion(row - 1, col - 1, row + 1, col + 1);
+    if (wasSolid != (tile != 0)) setSolid(row, col, tile != 0);
+}
+
+void Map::setSolid(int row, int col, bool solid) {
+    if (row < 0 || row >= rows || col < 0 || col >= cols) return;
+    const Uint64 bit = Uint64(1) << col;
+    if (((solidRows[row] & bit) != 0) == solid) return;
+    makeWritable();
+    if (solid) ownedSolidRows[row] |= bit;
+    else ownedSolidRows[row] &= ~bit;
+    updateSpawnColumn(row, col);
 }
 
 SDL_Rect Map::getTileSrcRect(int tileID) const {
     SDL_Rect src;
     src.w = TILE_WIDTH;
     src.h = TILE_HEIGHT;
-    src.x = (tileID % TILESET_COLS) * TILE_WIDTH;
-    src.y = (tileID / TILESET_COLS) * TILE_HEIGHT;
+    src.x = (tileID % tilesetCols) * TILE_WIDTH;
+    src.y = (tileID / tilesetCols) * TILE_HEIGHT;
     return src;
 }
 
+// Cell within a 3x3 terrain block (row * 3 + col) for each neighbour mask
+// N = 1, E = 2, S = 4, W = 8. Open tops get the grass row; a one-tile-wide
+// run uses the middle column, a one-tile-thick one the top row.
+static const Uint8 AUTOTILE_OFFSETS[16] = { 1, 7, 0, 6, 1, 4, 0, 3, 2, 8, 1, 7, 2, 5, 1, 4 };
+
+bool Map::isSolid(int row, int col) const {
+    // Beyond the edges counts as solid so terrain runs on off-screen without a border.
+    if (row < 0 || row >= rows || col < 0 || col >= cols) return true;
+    return tiles[row * cols + col] != 0;
+}
+
+void Map::resolveVisuals(int row0, int col0, int row1, int col1) {
+    if (row0 < 0) row0 = 0;
+    if (col0 < 0) col0 = 0;
+    if (row1 >= rows) row1 = rows - 1;
+    if (col1 >= cols) col1 = cols - 1;
+    for (int row = row0; row <= row1; ++row) {
+        for (int col = col0; col <= col1; ++col) {
+            Uint16 tile = tiles[row * cols + col];
+            if (!(tile & LEVEL_TILE_AUTOTILE)) {
+                visuals[row * cols + col] = tile;
+                continue;
+            }
+            int mask = (isSolid(row - 1, col) ? 1 : 0) | (isSolid(row, col + 1) ? 2 : 0) |
+                       (isSolid(row + 1, col) ? 4 : 0) | (isSolid(row, col - 1) ? 8 : 0);
+            int offset = AUTOTILE_OFFSETS[mask];
+            int base = tile & ~LEVEL_TILE_AUTOTILE;
+            visuals[row * cols + col] = static_cast<Uint16>(base + (offset / 3) * tilesetCols + offset % 3);
+        }
+    }
+}
+
+void Map::refreshRegion(int row0, int col0, int row1, int col1) {
+    resolveVisuals(row0, col0, row1, col1);
+    bakeRegion(row0, col0, row1, col1);
+}
+
+bool Map::bake(SDL_Renderer* renderer) {
+    releaseBake();
+    bakeRenderer = renderer;
+    if (!renderer || rows == 0 || !SDL_RenderTargetSupported(renderer)) return false;
+
+    baked = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                              cols * TILE_WIDTH * TILE_SCALE, rows * TILE_HEIGHT * TILE_SCALE);
+    if (!baked) {
+        printf("Could not create map texture, drawing tiles directly. SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+    bakedBytes = static_cast<size_t>(cols * TILE_WIDTH * TILE_SCALE) * (rows * TILE_HEIGHT * TILE_SCALE) * 4;
+    TextureManager::trackExternal(TEXTURE_CATEGORY_TILESET, bakedBytes, true);
+    SDL_SetTextureBlendMode(baked, SDL_BLENDMODE_BLEND);
+    bakeRegion(0, 0, rows - 1, cols - 1);
+    return true;
+}
+
+void Map::bakeRegion(int row0, int col0, int row1, int col1) {
+    SDL_Texture* tilesetTexture = TextureManager::get(tileset);
+    if (!baked || !tilesetTexture) return;
+    if (row0 < 0) row0 = 0;
+    if (col0 < 0) col0 = 0;
+    if (row1 >= rows) row1 = rows - 1;
+    if (col1 >= cols) col1 = cols - 1;
+    if (row0 > row1 || col0 > col1) return;
+
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(bakeRenderer);
+    Uint8 r, g, b, a;
+    SDL_BlendMode previousBlend;
+    SDL_GetRenderDrawColor(bakeRenderer, &r, &g, &b, &a);
+    SDL_GetRenderDrawBlendMode(bakeRenderer, &previousBlend);
+
+    SDL_SetRenderTarget(bakeRenderer, baked);
+    SDL_SetRenderDrawBlendMode(bakeRenderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(bakeRenderer, 0, 0, 0, 0);
+    SDL_Rect area = { col0 * tilePixelW, row0 * tilePixelH, (col1 - col0 + 1) * tilePixelW, (row1 - row0 + 1) * tilePixelH };
+    SDL_RenderFillRect(bakeRenderer, &area);
+
+    for (int row = row0; row <= row1; ++row) {
+        for (int col = col0; col <= col1; ++col) {
+            int tileID = visuals[row * cols + col];
+            if (tileID == 0) continue;
+            SDL_Rect src = getTileSrcRect(tileID);
+            SDL_Rect dst = { col * tilePixelW, row * tilePixelH, tilePixelW, tilePixelH };
+            SDL_RenderCopy(bakeRenderer, tilesetTexture, &src, &dst);
+        }
+    }
+
+    SDL_SetRenderTarget(bakeRenderer, previousTarget);
+    SDL_SetRenderDrawBlendMode(bakeRenderer, previousBlend);
+    SDL_SetRenderDrawColor(bakeRenderer, r, g, b, a);
+}
+
 void Map::render(SDL_Renderer* renderer) {
-    if (!tileset || !renderer) return;
+    if (!renderer) return;
+    if (baked) {
+        SDL_Rect dst = { 0, 0, cols * TILE_WIDTH * TILE_SCALE, rows * TILE_HEIGHT * TILE_SCALE };
+        SDL_RenderCopy(renderer, baked, nullptr, &dst);
+        return;
+    }
 
-    for (int row = 0; row < MAP_ROWS; ++row) {
-        for (int col = 0; col < MAP_COLS; ++col) {
-            int tileID = mapData[row][col];
+    SDL_Texture* tilesetTexture = TextureManager::get(tileset);
+    if (!tilesetTexture || visuals.empty()) return;
+
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int tileID = visuals[row * cols + col];
             if (tileID == 0) continue;
 
             SDL_Rect src = getTileSrcRect(tileID);
@@ -70,35 +427,215 @@ void Map::render(SDL_Renderer* renderer) {
                 TILE_WIDTH * TILE_SCALE,
                 TILE_HEIGHT * TILE_SCALE
             };
-            SDL_RenderCopy(renderer, tileset, &src, &dst);
+            SDL_RenderCopy(renderer, tilesetTexture, &src, &dst);
         }
     }
 }
 
-bool Map::isColliding(int x, int y, int w, int h) const {
-    int tilePixelW = TILE_WIDTH * TILE_SCALE;
-    int tilePixelH = TILE_HEIGHT * TILE_SCALE;
-
-    if (tilePixelW <= 0 || tilePixelH <= 0) return false;
+bool Map::tileSpan(int x, int y, int w, int h, int& top, int& bottom, Uint64& colMask) const {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
 
     int leftTile = x / tilePixelW;
     int rightTile = (x + w - 1) / tilePixelW;
-    int topTile = y / tilePixelH;
-    int bottomTile = (y + h - 1) / tilePixelH;
+    top = y / tilePixelH;
+    bottom = (y + h - 1) / tilePixelH;
 
     leftTile = (leftTile < 0) ? 0 : leftTile;
-    rightTile = (rightTile >= MAP_COLS) ? MAP_COLS - 1 : rightTile;
-    topTile = (topTile < 0) ? 0 : topTile;
-    bottomTile = (bottomTile >= MAP_ROWS) ? MAP_ROWS - 1 : bottomTile;
+    rightTile = (rightTile >= cols) ? cols - 1 : rightTile;
+    top = (top < 0) ? 0 : top;
+    bottom = (bottom >= rows) ? rows - 1 : bottom;
+
+    if (leftTile > rightTile || top > bottom) return false;
+    colMask = (~Uint64(0) >> (63 - rightTile)) & (~Uint64(0) << leftTile);
+    return true;
+}
+
+bool Map::isColliding(int x, int y, int w, int h) const {
+    int top, bottom;
+    Uint64 colMask;
+    if (!tileSpan(x, y, w, h, top, bottom, colMask)) return false;
+
+    Uint64 hits = 0;
+    for (int row = top; row <= bottom; ++row) {
+        hits |= solidRows[row];
+    }
+    return (hits & colMask) != 0;
+}
+
+int Map::isCollidingBatch(const SDL_Rect* rects, int count, Uint8* results) const {
+    int collisions = 0;
+    for (int i = 0; i < count; ++i) {
+        int top, bottom;
+        Uint64 colMask;
+        Uint64 hits = 0;
+        if (tileSpan(rects[i].x, rects[i].y, rects[i].w, rects[i].h, top, bottom, colMask)) {
+            for (int row = top; row <= bottom; ++row) {
+                hits |= solidRows[row];
+            }
+            hits &= colMask;
+        }
+        results[i] = hits != 0 ? 1 : 0;
+        collisions += results[i];
+    }
+    return collisions;
+}
+
+SweepHit Map::sweep(float x, float y, float w, float h, float dx, float dy) const {
+    const float tilePixelW = static_cast<float>(TILE_WIDTH * TILE_SCALE);
+    const float tilePixelH = static_cast<float>(TILE_HEIGHT * TILE_SCALE);
+    SweepHit best;
+
+    // Broadphase: every tile touched by the union of the start and end boxes.
+    float minX = dx < 0 ? x + dx : x;
+    float maxX = dx > 0 ? x + w + dx : x + w;
+    float minY = dy < 0 ? y + dy : y;
+    float maxY = dy > 0 ? y + h + dy : y + h;
+    int leftTile = static_cast<int>(std::floor(minX / tilePixelW));
+    int rightTile = static_cast<int>(std::ceil(maxX / tilePixelW)) - 1;
+    int topTile = static_cast<int>(std::floor(minY / tilePixelH));
+    int bottomTile = static_cast<int>(std::ceil(maxY / tilePixelH)) - 1;
+    if (leftTile < 0) leftTile = 0;
+    if (rightTile >= cols) rightTile = cols - 1;
+    if (topTile < 0) topTile = 0;
+    if (bottomTile >= rows) bottomTile = rows - 1;
+    if (leftTile > rightTile || topTile > bottomTile) return best;
+
+    const Uint64 colMask = (~Uint64(0) >> (63 - rightTile)) & (~Uint64(0) << leftTile);
+    const float inf = INFINITY;
 
     for (int row = topTile; row <= bottomTile; ++row) {
-        for (int col = leftTile; col <= rightTile; ++col) {
-            if (row >= 0 && row < MAP_ROWS && col >= 0 && col < MAP_COLS) {
-                if (mapData[row][col] != 0) {
-                    return true;
-                }
+        Uint64 bits = solidRows[row] & colMask;
+        float tileTop = row * tilePixelH;
+        float tileBottom = tileTop + tilePixelH;
+
+        // Entry/exit times on Y are shared by every tile in this row.
+        float yEntry, yExit;
+        if (dy > 0) { yEntry = (tileTop - (y + h)) / dy; yExit = (tileBottom - y) / dy; }
+        else if (dy < 0) { yEntry = (tileBottom - y) / dy; yExit = (tileTop - (y + h)) / dy; }
+        else if (y < tileBottom && y + h > tileTop) { yEntry = -inf; yExit = inf; }
+        else continue;
+
+        while (bits) {
+            int col = 0;
+            while (!(bits & (Uint64(1) << col))) ++col;
+            bits &= bits - 1;
+
+            float tileLeft = col * tilePixelW;
+            float tileRight = tileLeft + tilePixelW;
+            float xEntry, xExit;
+            if (dx > 0) { xEntry = (tileLeft - (x + w)) / dx; xExit = (tileRight - x) / dx; }
+            else if (dx < 0) { xEntry = (tileRight - x) / dx; xExit = (tileLeft - (x + w)) / dx; }
+            else if (x < tileRight && x + w > tileLeft) { xEntry = -inf; xExit = inf; }
+            else continue;
+
+            float entry = xEntry > yEntry ? xEntry : yEntry;
+            float exit = xExit < yExit ? xExit : yExit;
+            // Faces must actually meet (a corner graze has entry == exit, up to rounding),
+            // and the contact must fall inside this move. The negative slack keeps a box
+            // resting exactly on a face from slipping through on rounding error.
+            if (exit - entry <= SWEEP_SLACK || entry < -SWEEP_SLACK || entry > 1.0f) continue;
+            if (entry < 0.0f) entry = 0.0f;
+            if (best.hit && entry >= best.time) continue;
+
+            best.hit = true;
+            best.time = entry;
+            if (xEntry > yEntry) {
+                best.normalX = dx > 0 ? -1 : 1;
+                best.normalY = 0;
+                best.contactEdge = static_cast<int>(dx > 0 ? tileLeft : tileRight);
+            }
+            else {
+                // Ties (exact corner hits) resolve vertically so landings win.
+                best.normalX = 0;
+                best.normalY = dy > 0 ? -1 : 1;
+                best.contactEdge = static_cast<int>(dy > 0 ? tileTop : tileBottom);
             }
         }
     }
-    return false;
-}
\ No newline at end of file
+    return best;
+}
+
+// A time within a move as num / den with den > 0; den == 0 is -inf or +inf by the sign of num.
+struct SweepTime {
+    Sint64 num, den;
+};
+
+static bool sweepTimeLess(SweepTime a, SweepTime b) {
+    int aInf = a.den == 0 ? (a.num < 0 ? -1 : 1) : 0;
+    int bInf = b.den == 0 ? (b.num < 0 ? -1 : 1) : 0;
+    if (aInf || bInf) return aInf < bInf;
+    return a.num * b.den < b.num * a.den;
+}
+
+SweepHitFixed Map::sweepFixed(Fixed x, Fixed y, Fixed w, Fixed h, Fixed dx, Fixed dy) const {
+    const Sint64 tileW = Fixed::fromInt(TILE_WIDTH * TILE_SCALE).raw;
+    const Sint64 tileH = Fixed::fromInt(TILE_HEIGHT * TILE_SCALE).raw;
+    SweepHitFixed best;
+
+    // Broadphase: every tile touched by the union of the start and end boxes.
+    Sint32 minX = dx.raw < 0 ? x.raw + dx.raw : x.raw;
+    Sint32 maxX = dx.raw > 0 ? x.raw + w.raw + dx.raw : x.raw + w.raw;
+    Sint32 minY = dy.raw < 0 ? y.raw + dy.raw : y.raw;
+    Sint32 maxY = dy.raw > 0 ? y.raw + h.raw + dy.raw : y.raw + h.raw;
+    int leftTile = Fixed::floorDiv(minX, static_cast<Sint32>(tileW));
+    int rightTile = -Fixed::floorDiv(-maxX, static_cast<Sint32>(tileW)) - 1;
+    int topTile = Fixed::floorDiv(minY, static_cast<Sint32>(tileH));
+    int bottomTile = -Fixed::floorDiv(-maxY, static_cast<Sint32>(tileH)) - 1;
+    if (leftTile < 0) leftTile = 0;
+    if (rightTile >= cols) rightTile = cols - 1;
+    if (topTile < 0) topTile = 0;
+    if (bottomTile >= rows) bottomTile = rows - 1;
+    if (leftTile > rightTile || topTile > bottomTile) return best;
+
+    const Uint64 colMask = (~Uint64(0) >> (63 - rightTile)) & (~Uint64(0) << leftTile);
+    const SweepTime negInf = { -1, 0 }, posInf = { 1, 0 };
+    const SweepTime zero = { 0, 1 }, one = { 1, 1 };
+
+    for (int row = topTile; row <= bottomTile; ++row) {
+        Uint64 bits = solidRows[row] & colMask;
+        Sint64 tileTop = row * tileH;
+        Sint64 tileBottom = tileTop + tileH;
+
+        SweepTime yEntry, yExit;
+        if (dy.raw > 0) { yEntry = { tileTop - (y.raw + h.raw), dy.raw }; yExit = { tileBottom - y.raw, dy.raw }; }
+        else if (dy.raw < 0) { yEntry = { y.raw - tileBottom, -dy.raw }; yExit = { y.raw + h.raw - tileTop, -dy.raw }; }
+        else if (y.raw < tileBottom && y.raw + h.raw > tileTop) { yEntry = negInf; yExit = posInf; }
+        else continue;
+
+        while (bits) {
+            int col = 0;
+            while (!(bits & (Uint64(1) << col))) ++col;
+            bits &= bits - 1;
+
+            Sint64 tileLeft = col * tileW;
+            Sint64 tileRight = tileLeft + tileW;
+            SweepTime xEntry, xExit;
+            if (dx.raw > 0) { xEntry = { tileLeft - (x.raw + w.raw), dx.raw }; xExit = { tileRight - x.raw, dx.raw }; }
+            else if (dx.raw < 0) { xEntry = { x.raw - tileRight, -dx.raw }; xExit = { x.raw + w.raw - tileLeft, -dx.raw }; }
+            else if (x.raw < tileRight && x.raw + w.raw > tileLeft) { xEntry = negInf; xExit = posInf; }
+            else continue;
+
+            SweepTime entry = sweepTimeLess(xEntry, yEntry) ? yEntry : xEntry;
+            SweepTime exit = sweepTimeLess(xExit, yExit) ? xExit : yExit;
+            if (!sweepTimeLess(entry, exit) || sweepTimeLess(entry, zero) || sweepTimeLess(one, entry)) continue;
+            SweepTime bestTime = { best.timeNum, best.timeDen };
+            if (best.hit && !sweepTimeLess(entry, bestTime)) continue;
+
+            best.hit = true;
+            best.timeNum = entry.num;
+            best.timeDen = entry.den;
+            if (sweepTimeLess(yEntry, xEntry)) {
+                best.normalX = dx.raw > 0 ? -1 : 1;
+                best.normalY = 0;
+                best.contactEdge = (dx.raw > 0 ? col : col + 1) * TILE_WIDTH * TILE_SCALE;
+            }
+            else {
+                best.normalX = 0;
+                best.normalY = dy.raw > 0 ? -1 : 1;
+                best.contactEdge = (dy.raw > 0 ? row : row + 1) * TILE_HEIGHT * TILE_SCALE;
+            }
+        }
+    }
+    return best;
+}
@@ -1,19 +1,138 @@
 ﻿#pragma once
 #include <SDL.h>
 #include "Constants.h"
+#include "TextureManager.h"
+#include "LevelFormat.h"
+#include "MappedFile.h"
+#include "Fixed.h"
+#include <vector>
+
+// Result of sweeping a box through the tile grid.
+struct SweepHit {
+    bool hit = false;
+    float time = 1.0f;     // fraction of the move completed before contact, in [0, 1]
+    int normalX = 0;       // contact normal: -1/+1 on the blocked axis, 0 otherwise
+    int normalY = 0;
+    int contactEdge = 0;   // pixel coordinate of the tile face that was hit
+};
+
+// SweepHit for Map::sweepFixed(); the contact time is timeNum / timeDen exactly.
+struct SweepHitFixed {
+    bool hit = false;
+    Sint64 timeNum = 1, timeDen = 1;
+    int normalX = 0;
+    int normalY = 0;
+    int contactEdge = 0;
+
+    // The part of a displacement covered before contact, rounded toward zero.
+    Fixed scale(Fixed d) const { return Fixed::fromRaw(static_cast<Sint32>(d.raw * timeNum / timeDen)); }
+};
+
+// Top-left pixel position of a spawn slot.
+struct SpawnPoint {
+    Sint16 x, y;
+};
 
 class Map {
 public:
     Map();
     ~Map();
 
-    void init(const char* tilesetPath, SDL_Renderer* renderer);
+    // Maps a level built by tools/level_import.py and loads the tileset it names.
+    // Tiles, collision masks, spawns and entities are used straight from the mapping.
+    bool init(const char* levelPath, SDL_Renderer* renderer);
     void render(SDL_Renderer* renderer);
+    // Draws every tile once into a map-sized render target so render() is a single
+    // copy. Call again after SDL_RENDER_TARGETS_RESET; falls back to per-tile drawing.
+    bool bake(SDL_Renderer* renderer);
+    // Destroys the baked texture; render() draws tiles directly until the next bake().
+    void releaseBake();
+    // Frees everything the map holds on the renderer. Call before the renderer goes.
+    void shutdown();
     bool isColliding(int x, int y, int w, int h) const;
+    // Tests every rect against the grid; results[i] is 1 when rects[i] hits a solid tile.
+    // Returns the number of colliding rects.
+    int isCollidingBatch(const SDL_Rect* rects, int count, Uint8* results) const;
+    // Continuous test of a w*h box at (x, y) moving by (dx, dy): earliest solid tile it
+    // touches, exact for any velocity. Boxes already overlapping a tile ignore that tile.
+    SweepHit sweep(float x, float y, float w, float h, float dx, float dy) const;
+    // sweep() in Q16.16 for the deterministic path. Same rules and tie-breaks, but
+    // entry times are exact fractions compared by cross-multiplication, so there is
+    // no rounding and no slack.
+    SweepHitFixed sweepFixed(Fixed x, Fixed y, Fixed w, Fixed h, Fixed dx, Fixed dy) const;
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int getTile(int row, int col) const { return tiles[row * cols + col]; }
+    int getSpawnCount() const { return header ? static_cast<int>(header->spawnCount) : 0; }
+    const LevelSpawn* getSpawns() const { return spawns; }
+    int getEntityCount() const { return header ? static_cast<int>(header->entityCount) : 0; }
+    const LevelEntity* getEntities() const { return entities; }
+    bool getPlayerSpawn(float& x, float& y) const;
+    // Where a one-tile collectible may appear: the level's collectible spawns if it
+    // lists any, otherwise every free on-screen cell with ground a short fall below.
+    // The list only grows, so indices stay valid across tile edits; cells that stop
+    // qualifying are dropped from getActiveSpawns() instead.
+    const std::vector<SpawnPoint>& getCollectibleSpawns() const { return collectibleSpawns; }
+    const std::vector<Uint16>& getActiveSpawns() const { return activeSpawns; }
+    bool isSpawnActive(int spawn) const {
+        return spawn >= 0 && spawn < static_cast<int>(activeSlot.size()) && activeSlot[spawn] >= 0;
+    }
+    // Marks every cell the pixel area touches as off limits: spawns there are dropped
+    // for good and the cells never qualify again, whatever the tiles do later.
+    void blockArea(const SDL_Rect& area);
+    bool isCellBlocked(int row, int col) const { return (blockedRows[row] >> col) & 1; }
+
+    // Runtime edits. Each one touches the cell, its neighbours' autotile variants, the
+    // baked texture under them and the spawn cells above, never the whole map.
+    void setTile(int row, int col, Uint16 tile);
+    // Collision only, for blocks drawn by their own system rather than from the tileset.
+    void setSolid(int row, int col, bool solid);
 
 private:
+    bool validate(const char* levelPath) const;
+    void buildSpawnTable();
+    void makeWritable();
+    void updateSpawnColumn(int row, int col);
+    bool spawnCellQualifies(int row, int col) const;
+    void setSpawnActive(int spawn, bool isActive);
+
     SDL_Rect getTileSrcRect(int tileID) const;
+    // Recomputes the drawn variant of every cell in the (inclusive) region and
+    // re-bakes it; autotiled cells depend on their neighbours, so callers grow
+    // the region by one cell around a change.
+    void refreshRegion(int row0, int col0, int row1, int col1);
+    void resolveVisuals(int row0, int col0, int row1, int col1);
+    void bakeRegion(int row0, int col0, int row1, int col1);
+    bool isSolid(int row, int col) const;
+    bool tileSpan(int x, int y, int w, int h, int& top, int& bottom, Uint64& colMask) const;
+
+    TextureHandle tileset;
+    int tilesetCols;
+
+    // Everything below points into the mapped level file; the first runtime edit
+    // repoints tiles and solidRows at the owned copies.
+    MappedFile file;
+    const LevelHeader* header;
+    const Uint16* tiles;
+    const Uint64* solidRows;   // one bit per column, set for solid tiles
+    const LevelSpawn* spawns;
+    const LevelEntity* entities;
+    int rows, cols;
+    std::vector<Uint16> ownedTiles;
+    std::vector<Uint64> ownedSolidRows;
+
+    // Tileset index drawn in each cell (0 = nothing), resolved from tiles with autotiling.
+    std::vector<Uint16> visuals;
+    SDL_Texture* baked;
+    size_t bakedBytes;      // as reported to TextureManager::trackExternal
+    SDL_Renderer* bakeRenderer;
 
-    SDL_Texture* tileset;
-    int mapData[MAP_ROWS][MAP_COLS];
+    std::vector<SpawnPoint> collectibleSpawns;
+    std::vector<Uint16> activeSpawns;   // indices into collectibleSpawns, in no particular order
+    std::vector<int> activeSlot;        // per spawn: position in activeSpawns, -1 when inactive
+    std::vector<int> spawnOfCell;       // per cell: its spawn index, -1 when it never qualified
+    std::vector<Uint64> blockedRows;    // one bit per column, set for cells given to blockArea()
+    bool explicitSpawns;                // level lists its own spawns, which are never re-evaluated
+    int spawnLastRow, spawnLastCol;
 };
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+    view(nullptr),
+    length(0)
+#ifdef _WIN32
+    , fileHandle(INVALID_HANDLE_VALUE),
+    mappingHandle(nullptr)
+#else
+    , fd(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char* path) {
+    close();
+    fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        printf("Unable to open '%s' (error %lu)\n", path, GetLastError());
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        printf("Unable to map '%s': empty or unreadable file\n", path);
+        close();
+        return false;
+    }
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle) {
+        view = static_cast<const unsigned char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!view) {
+        printf("Unable to map '%s' (error %lu)\n", path, GetLastError());
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (view) UnmapViewOfFile(view);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+    view = nullptr;
+    length = 0;
+    mappingHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::open(const char* path) {
+    close();
+    fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Unable to open '%s'\n", path);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        printf("Unable to map '%s': empty or unreadable file\n", path);
+        close();
+        return false;
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        printf("Unable to map '%s'\n", path);
+        close();
+        return false;
+    }
+    view = static_cast<const unsigned char*>(mapped);
+    length = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (view) munmap(const_cast<unsigned char*>(view), length);
+    if (fd >= 0) ::close(fd);
+    view = nullptr;
+    length = 0;
+    fd = -1;
+}
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+
+// Read-only memory mapping of a whole file (MapViewOfFile on Windows, mmap elsewhere).
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const char* path);
+    void close();
+
+    const unsigned char* data() const { return view; }
+    size_t size() const { return length; }
+    bool isOpen() const { return view != nullptr; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const unsigned char* view;
+    size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+};
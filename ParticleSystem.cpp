@@ -0,0 +1,147 @@
+#include "ParticleSystem.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_USE_SSE2 1
+#endif
+
+const ParticleSystem::StyleDef ParticleSystem::styles[STYLE_COUNT] = {
+    // STYLE_APPLE_COLLECT: red sparks thrown in every direction
+    { { 230, 50, 40, 255 }, 6, 0.10f, 0.35f, -3.14159f, 3.14159f, 350.0f, 650.0f, 0.0006f },
+    // STYLE_LANDING_DUST: pale puffs kicked sideways and slightly up
+    { { 225, 215, 195, 255 }, 4, 0.05f, 0.18f, -3.0f, -0.14f, 200.0f, 400.0f, 0.0002f }
+};
+
+ParticleSystem::ParticleSystem() :
+    posX(CAPACITY), posY(CAPACITY),
+    velX(CAPACITY), velY(CAPACITY),
+    gravity(CAPACITY),
+    life(CAPACITY),
+    style(CAPACITY),
+    liveCount(0),
+    emittedThisFrame(0),
+    rngState(0x9E3779B9u),
+    drawRects(CAPACITY)
+{
+}
+
+ParticleSystem::~ParticleSystem() {
+}
+
+float ParticleSystem::randomRange(float lo, float hi) {
+    // xorshift32: cheap and good enough for visual noise
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return lo + (hi - lo) * static_cast<float>(rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::emitBurst(float x, float y, int count, Style burstStyle) {
+    int budget = MAX_EMIT_PER_FRAME - emittedThisFrame;
+    if (count > budget) count = budget;
+    if (count > CAPACITY - liveCount) count = CAPACITY - liveCount;
+    if (count <= 0) return;
+
+    const StyleDef& def = styles[burstStyle];
+    for (int n = 0; n < count; ++n) {
+        int i = liveCount++;
+        float angle = randomRange(def.minAngle, def.maxAngle);
+        float speed = randomRange(def.minSpeed, def.maxSpeed);
+        posX[i] = x;
+        posY[i] = y;
+        velX[i] = std::cos(angle) * speed;
+        velY[i] = std::sin(angle) * speed;
+        gravity[i] = def.gravity;
+        life[i] = randomRange(def.minLifeMs, def.maxLifeMs);
+        style[i] = burstStyle;
+    }
+    emittedThisFrame += count;
+}
+
+void ParticleSystem::update(Uint32 dtMs) {
+    emittedThisFrame = 0;
+    if (liveCount == 0) return;
+    integrate(static_cast<float>(dtMs));
+    compact();
+}
+
+void ParticleSystem::integrate(float dtMs) {
+    int i = 0;
+#ifdef PARTICLES_USE_SSE2
+    const __m128 dt = _mm_set1_ps(dtMs);
+    for (; i + 4 <= liveCount; i += 4) {
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(&velY[i]), _mm_mul_ps(_mm_loadu_ps(&gravity[i]), dt));
+        __m128 px = _mm_add_ps(_mm_loadu_ps(&posX[i]), _mm_mul_ps(_mm_loadu_ps(&velX[i]), dt));
+        __m128 py = _mm_add_ps(_mm_loadu_ps(&posY[i]), _mm_mul_ps(vy, dt));
+        __m128 lf = _mm_sub_ps(_mm_loadu_ps(&life[i]), dt);
+        _mm_storeu_ps(&velY[i], vy);
+        _mm_storeu_ps(&posX[i], px);
+        _mm_storeu_ps(&posY[i], py);
+        _mm_storeu_ps(&life[i], lf);
+    }
+#endif
+    for (; i < liveCount; ++i) {
+        velY[i] += gravity[i] * dtMs;
+        posX[i] += velX[i] * dtMs;
+        posY[i] += velY[i] * dtMs;
+        life[i] -= dtMs;
+    }
+}
+
+void ParticleSystem::compact() {
+    // Swap-remove dead particles; order does not matter for drawing.
+    int i = 0;
+    while (i < liveCount) {
+        if (life[i] > 0.0f) {
+            ++i;
+            continue;
+        }
+        int last = --liveCount;
+        posX[i] = posX[last];
+        posY[i] = posY[last];
+        velX[i] = velX[last];
+        velY[i] = velY[last];
+        gravity[i] = gravity[last];
+        life[i] = life[last];
+        style[i] = style[last];
+    }
+}
+
+void ParticleSystem::render(SDL_Renderer* renderer) {
+    if (!renderer || liveCount == 0) return;
+
+    // Counting sort by style so every style is a single SDL_RenderFillRects call.
+    int offsets[STYLE_COUNT + 1] = {};
+    for (int i = 0; i < liveCount; ++i) {
+        ++offsets[style[i] + 1];
+    }
+    for (int s = 0; s < STYLE_COUNT; ++s) {
+        offsets[s + 1] += offsets[s];
+    }
+    int cursor[STYLE_COUNT];
+    for (int s = 0; s < STYLE_COUNT; ++s) {
+        cursor[s] = offsets[s];
+    }
+    for (int i = 0; i < liveCount; ++i) {
+        const StyleDef& def = styles[style[i]];
+        SDL_Rect& r = drawRects[cursor[style[i]]++];
+        r.x = static_cast<int>(posX[i]) - def.size / 2;
+        r.y = static_cast<int>(posY[i]) - def.size / 2;
+        r.w = def.size;
+        r.h = def.size;
+    }
+
+    for (int s = 0; s < STYLE_COUNT; ++s) {
+        int count = offsets[s + 1] - offsets[s];
+        if (count == 0) continue;
+        const SDL_Color& c = styles[s].color;
+        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+        SDL_RenderFillRects(renderer, &drawRects[offsets[s]], count);
+    }
+}
+
+void ParticleSystem::clear() {
+    liveCount = 0;
+    emittedThisFrame = 0;
+}
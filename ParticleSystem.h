@@ -0,0 +1,55 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Fixed-capacity particle pool in structure-of-arrays layout. All storage is
+// allocated once in the constructor; emitting past capacity or past the
+// per-frame budget drops particles instead of growing or stalling.
+class ParticleSystem {
+public:
+    static const int CAPACITY = 32768;
+    static const int MAX_EMIT_PER_FRAME = 4096;
+
+    enum Style : Uint8 {
+        STYLE_APPLE_COLLECT,
+        STYLE_LANDING_DUST,
+        STYLE_COUNT
+    };
+
+    ParticleSystem();
+    ~ParticleSystem();
+
+    void emitBurst(float x, float y, int count, Style style);
+    void update(Uint32 dtMs);
+    void render(SDL_Renderer* renderer);
+    void clear();
+
+    int getLiveCount() const { return liveCount; }
+
+private:
+    struct StyleDef {
+        SDL_Color color;
+        int size;
+        float minSpeed, maxSpeed;  // px per ms
+        float minAngle, maxAngle;  // radians, 0 = right, -pi/2 = up
+        float minLifeMs, maxLifeMs;
+        float gravity;             // px per ms^2
+    };
+    static const StyleDef styles[STYLE_COUNT];
+
+    void integrate(float dtMs);
+    void compact();
+    float randomRange(float lo, float hi);
+
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> gravity;
+    std::vector<float> life;
+    std::vector<Uint8> style;
+    int liveCount;
+    int emittedThisFrame;
+    Uint32 rngState;
+
+    // Scratch for the batched draw: rects bucketed by style, one SDL call per style.
+    std::vector<SDL_Rect> drawRects;
+};
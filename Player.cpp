@@ -1,198 +1,344 @@
 ﻿#include "Player.h"
-#include "TextureManager.h"
 #include "Map.h"
 #include <SDL.h>
-#include <string>
 #include <cstdio>
 
+// Impacts slower than this are the resting ground contact, not a landing.
+static const float LANDING_MIN_SPEED = 3.0f;
+
+// The physics constants are exact in binary, so these conversions are exact too.
+static const Fixed GRAVITY_FX = Fixed::fromFloat(GRAVITY);
+static const Fixed JUMP_FORCE_FX = Fixed::fromFloat(JUMP_FORCE);
+static const Fixed MOVE_SPEED_FX = Fixed::fromFloat(MOVE_SPEED);
+static const Fixed LANDING_MIN_SPEED_FX = Fixed::fromFloat(LANDING_MIN_SPEED);
+
 Player::Player() :
-    x(100.0f), y(500.0f),
-    speed(MOVE_SPEED),
-    velX(0.0f), velY(0.0f),
-    onGround(false),
+    fixedPhysics(false),
+    spawnX(100.0f), spawnY(448.0f),
+    moveDir(0),
+    jumpPressed(false),
+    jumpWasDown(false),
+    jumpBufferTicks(0),
+    coyoteTicks(0),
+    jumpQueuedTicks(0),
+    ticksSinceGround(0),
+    coyoteSpent(false),
     isMovingHorizontally(false),
     justJumped(false),
-    frame(0), frameDelay(6), frameCount(0),
-    currentAnim("idle"),
-    flip(SDL_FLIP_NONE),
-    srcRect{ 0, 0, 32, 32 },
-    playerScale(2)
+    justLanded(false),
+    landingSpeed(0.0f),
+    world(nullptr)
 {
-
+    body.x = spawnX;
+    body.y = spawnY;
+    fixedBody.x = Fixed::fromFloat(spawnX);
+    fixedBody.y = Fixed::fromFloat(spawnY);
 }
 
 Player::~Player() {
-    animations.clear();
 }
 
-void Player::init(SDL_Renderer* renderer) {
-    loadAnimations(renderer);
-    if (!animations.empty() && animations.count(currentAnim)) {
-        Animation& startAnim = animations[currentAnim];
-        dstRect = { static_cast<int>(x), static_cast<int>(y),
-                    startAnim.frameW * playerScale, startAnim.frameH * playerScale };
-    }
-    else {
-        dstRect = { static_cast<int>(x), static_cast<int>(y),
-                    32 * playerScale, 32 * playerScale };
-    }
+void Player::init(World& gameWorld) {
+    world = &gameWorld;
+    // Clip sheets are owned by AnimationLibrary, loaded from assets/animations.txt.
+    // Every player clip has the same frame size, so the body is sized once here.
+    const AnimClip& startClip = AnimationLibrary::get(ANIM_PLAYER_IDLE);
+    int w = startClip.frameW * PLAYER_SCALE;
+    int h = startClip.frameH * PLAYER_SCALE;
+    body.w = static_cast<float>(w);
+    body.h = static_cast<float>(h);
+    fixedBody.w = Fixed::fromInt(w);
+    fixedBody.h = Fixed::fromInt(h);
+
+    entity = world->create(World::COMPONENT_TRANSFORM | World::COMPONENT_AABB |
+                           World::COMPONENT_ANIMATION | World::COMPONENT_SPRITE);
+    world->setSprite(entity, PLAYER_SCALE, World::RENDER_LAYER_ACTORS);
+    world->setBoxSize(entity, w, h);
+    world->playClip(entity, ANIM_PLAYER_IDLE);
+    syncEntity();
     printf("Player initialized.\n");
 }
 
-void Player::loadAnimations(SDL_Renderer* renderer) {
-    printf("Loading player animations...\n");
-    animations["idle"] = { TextureManager::loadTexture("assets/animation/idle32x32.png", renderer), 11, 32, 32 };
-    animations["run"] = { TextureManager::loadTexture("assets/animation/run32x32.png", renderer), 12, 32, 32 };
-    animations["jump"] = { TextureManager::loadTexture("assets/animation/jump32x32.png", renderer), 1, 32, 32 };
-    animations["fall"] = { TextureManager::loadTexture("assets/animation/fall32x32.png", renderer), 1, 32, 32 };
-    printf("Player animations loaded.\n");
+void Player::resetBody(PlayerBody& body, float x, float y) {
+    body.x = x;
+    body.y = y;
+    body.velX = body.velY = 0.0f;
+    body.onGround = false;
+}
+
+void Player::resetBody(PlayerBodyFixed& body, float x, float y) {
+    // Level spawns are whole pixels, so the fixed body starts exactly there.
+    body.x = Fixed::fromFloat(x);
+    body.y = Fixed::fromFloat(y);
+    body.velX = body.velY = Fixed();
+    body.onGround = false;
+}
+
+void Player::syncEntity() {
+    if (!world) return;
+    SDL_Rect bounds = getBounds();
+    world->setPosition(entity, static_cast<float>(bounds.x), static_cast<float>(bounds.y));
+}
+
+void Player::setSpawn(float newSpawnX, float newSpawnY) {
+    spawnX = newSpawnX;
+    spawnY = newSpawnY;
+    resetBody(body, spawnX, spawnY);
+    resetBody(fixedBody, spawnX, spawnY);
+    // Appearing in the air is not walking off a ledge.
+    coyoteSpent = true;
+    syncEntity();
+}
+
+void Player::applyLift(int speed) {
+    // Whole pixels per tick, so the fixed body gets the exact same value.
+    if (body.velY > -speed) body.velY = static_cast<float>(-speed);
+    if (fixedBody.velY > Fixed::fromInt(-speed)) fixedBody.velY = Fixed::fromInt(-speed);
+    body.onGround = false;
+    fixedBody.onGround = false;
+    coyoteSpent = true;
+}
+
+void Player::setFixedPhysics(bool enabled) {
+    fixedPhysics = enabled;
+    if (enabled) setSpawn(spawnX, spawnY);
+}
+
+SDL_Rect Player::getBounds() const {
+    SDL_Rect bounds;
+    bounds.w = static_cast<int>(body.w);
+    bounds.h = static_cast<int>(body.h);
+    if (fixedPhysics) {
+        bounds.x = fixedBody.x.floorToInt();
+        bounds.y = fixedBody.y.floorToInt();
+    }
+    else {
+        bounds.x = static_cast<int>(body.x);
+        bounds.y = static_cast<int>(body.y);
+    }
+    return bounds;
 }
 
 void Player::handleInput(const Uint8* keystate) {
     isMovingHorizontally = false;
-    velX = 0;
+    moveDir = 0;
 
     if (keystate[SDL_SCANCODE_A]) {
-        velX = -speed;
+        moveDir = -1;
         isMovingHorizontally = true;
-        flip = SDL_FLIP_HORIZONTAL;
+        if (world) world->setFlip(entity, SDL_FLIP_HORIZONTAL);
     }
     if (keystate[SDL_SCANCODE_D]) {
-        velX = speed;
+        moveDir = 1;
         isMovingHorizontally = true;
-        flip = SDL_FLIP_NONE;
-    }
-    if (keystate[SDL_SCANCODE_SPACE] && onGround) {
-        velY = JUMP_FORCE;
-        onGround = false;
-        justJumped = true;
+        if (world) world->setFlip(entity, SDL_FLIP_NONE);
     }
+    jumpPressed = keystate[SDL_SCANCODE_SPACE] != 0;
+    // A new press stays queued for the buffer window (this tick when it is 0).
+    if (jumpPressed && !jumpWasDown) jumpQueuedTicks = jumpBufferTicks + 1;
+    jumpWasDown = jumpPressed;
 }
 
-void Player::update(const Map& map) {
-    float oldX = x;
-    float oldY = y;
-
-    if (!onGround) {
-        velY += GRAVITY;
+PlayerStepResult Player::simulateStep(const Map& map, PlayerBody& body, int moveDir, bool jump) {
+    PlayerStepResult result;
+    body.velX = moveDir * MOVE_SPEED;
+    if (jump && body.onGround) {
+        body.velY = JUMP_FORCE;
+        body.onGround = false;
+        result.jumped = true;
     }
 
+    // Gravity applies while standing too: the floor contact it produces every
+    // tick is what keeps onGround set.
+    body.velY += GRAVITY;
 
-    x += velX;
-    y += velY;
+    // Sweep the whole move against the grid and slide along whatever we hit.
+    // Each contact zeroes one axis, so two passes resolve any move.
+    float dx = body.velX;
+    float dy = body.velY;
+    bool hitFloor = false;
+    for (int pass = 0; pass < 2 && (dx != 0.0f || dy != 0.0f); ++pass) {
+        SweepHit hit = map.sweep(body.x, body.y, body.w, body.h, dx, dy);
+        if (!hit.hit) {
+            body.x += dx;
+            body.y += dy;
+            break;
+        }
 
-    if (animations.count(currentAnim)) {
-        dstRect.w = animations[currentAnim].frameW * playerScale;
-        dstRect.h = animations[currentAnim].frameH * playerScale;
-    }
-    else {
-        dstRect.w = 32 * playerScale;
-        dstRect.h = 32 * playerScale;
+        // Advance to the contact, snapping the blocked axis onto the tile face.
+        float remaining = 1.0f - hit.time;
+        if (hit.normalX != 0) {
+            body.x = hit.normalX < 0 ? hit.contactEdge - body.w : static_cast<float>(hit.contactEdge);
+            body.y += dy * hit.time;
+            body.velX = 0;
+            dx = 0;
+            dy *= remaining;
+        }
+        else {
+            body.y = hit.normalY < 0 ? hit.contactEdge - body.h : static_cast<float>(hit.contactEdge);
+            body.x += dx * hit.time;
+            if (hit.normalY < 0) {
+                if (body.velY >= LANDING_MIN_SPEED) {
+                    result.landed = true;
+                    result.landingSpeed = body.velY;
+                }
+                hitFloor = true;
+            }
+            body.velY = 0;
+            dy = 0;
+            dx *= remaining;
+        }
     }
-    dstRect.x = static_cast<int>(x);
-    dstRect.y = static_cast<int>(y);
+    body.onGround = hitFloor;
 
+    // Screen Boundaries
+    if (body.x < 0) { body.x = 0; body.velX = 0; }
+    if (body.x + body.w > WINDOW_WIDTH) { body.x = WINDOW_WIDTH - body.w; body.velX = 0; }
+    if (body.y < 0) { body.y = 0; body.velY = 0; }
+    return result;
+}
 
-    dstRect.y = static_cast<int>(oldY);
-    if (map.isColliding(dstRect.x, dstRect.y, dstRect.w, dstRect.h)) {
-        x = oldX;
-        velX = 0;
-        dstRect.x = static_cast<int>(x);
+PlayerStepResult Player::simulateStepFixed(const Map& map, PlayerBodyFixed& body, int moveDir, bool jump) {
+    PlayerStepResult result;
+    body.velX = MOVE_SPEED_FX * moveDir;
+    if (jump && body.onGround) {
+        body.velY = JUMP_FORCE_FX;
+        body.onGround = false;
+        result.jumped = true;
     }
+    body.velY += GRAVITY_FX;
 
+    // Same two-pass slide as simulateStep(), on the exact integer sweep.
+    Fixed dx = body.velX;
+    Fixed dy = body.velY;
+    bool hitFloor = false;
+    for (int pass = 0; pass < 2 && (dx.raw != 0 || dy.raw != 0); ++pass) {
+        SweepHitFixed hit = map.sweepFixed(body.x, body.y, body.w, body.h, dx, dy);
+        if (!hit.hit) {
+            body.x += dx;
+            body.y += dy;
+            break;
+        }
 
-    dstRect.y = static_cast<int>(y);
-    if (map.isColliding(dstRect.x, dstRect.y, dstRect.w, dstRect.h)) {
-        if (velY > 0) {
-            int tilePixelH = TILE_HEIGHT * TILE_SCALE;
-            int collidedTileRow = static_cast<int>((y + dstRect.h - 1) / tilePixelH);
-            y = static_cast<float>(collidedTileRow * tilePixelH - dstRect.h);
-            velY = 0;
-            onGround = true;
+        Fixed edge = Fixed::fromInt(hit.contactEdge);
+        if (hit.normalX != 0) {
+            body.x = hit.normalX < 0 ? edge - body.w : edge;
+            Fixed moved = hit.scale(dy);
+            body.y += moved;
+            body.velX = Fixed();
+            dx = Fixed();
+            dy -= moved;
         }
-        else if (velY < 0) { // Collided while jumping up
-            int tilePixelH = TILE_HEIGHT * TILE_SCALE;
-            int collidedTileRow = static_cast<int>(y / tilePixelH);
-            y = static_cast<float>((collidedTileRow + 1) * tilePixelH);
-            velY = 0;
+        else {
+            body.y = hit.normalY < 0 ? edge - body.h : edge;
+            Fixed moved = hit.scale(dx);
+            body.x += moved;
+            if (hit.normalY < 0) {
+                if (body.velY >= LANDING_MIN_SPEED_FX) {
+                    result.landed = true;
+                    result.landingSpeed = body.velY.toFloat();
+                }
+                hitFloor = true;
+            }
+            body.velY = Fixed();
+            dy = Fixed();
+            dx -= moved;
         }
-        dstRect.y = static_cast<int>(y); // Update rect Y
     }
-    else {
-        onGround = false; // No Y collision means in the air
+    body.onGround = hitFloor;
+
+    const Fixed zero = Fixed();
+    const Fixed screenW = Fixed::fromInt(WINDOW_WIDTH);
+    if (body.x < zero) { body.x = zero; body.velX = zero; }
+    if (body.x + body.w > screenW) { body.x = screenW - body.w; body.velX = zero; }
+    if (body.y < zero) { body.y = zero; body.velY = zero; }
+    return result;
+}
+
+Uint64 Player::hashState(Uint64 hash) const {
+    // Field by field so struct padding never leaks in.
+    const Sint32 state[7] = {
+        fixedBody.x.raw, fixedBody.y.raw, fixedBody.velX.raw, fixedBody.velY.raw,
+        jumpQueuedTicks, ticksSinceGround,
+        (fixedBody.onGround ? 1 : 0) | (coyoteSpent ? 2 : 0) | (jumpWasDown ? 4 : 0)
+    };
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(state);
+    for (size_t i = 0; i < sizeof(state); ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
     }
+    return hash;
+}
 
-    // Screen Boundaries
-    if (x < 0) { x = 0; velX = 0; }
-    if (x + dstRect.w > WINDOW_WIDTH) { x = static_cast<float>(WINDOW_WIDTH - dstRect.w); velX = 0; }
-    if (y < 0) { y = 0; velY = 0; }
-    if (y > WINDOW_HEIGHT) {
-        x = 100.0f; y = 500.0f; velX = 0.0f; velY = 0.0f; onGround = false; currentAnim = "fall";
+void Player::update(const Map& map) {
+    AnimClipId nextClip = static_cast<AnimClipId>(world->getClip(entity));
+
+    // Coyote time: shortly after walking off a ledge, a jump still counts as from
+    // the ground. The step only jumps from the ground, so the body is put back on it.
+    bool wantJump = jumpPressed || jumpQueuedTicks > 0;
+    bool grounded = fixedPhysics ? fixedBody.onGround : body.onGround;
+    if (wantJump && !grounded && !coyoteSpent && ticksSinceGround <= coyoteTicks) {
+        fixedBody.onGround = true;
+        body.onGround = true;
     }
 
-    // Animation State
-    std::string previousAnim = currentAnim;
-    if (onGround) {
-        currentAnim = isMovingHorizontally ? "run" : "idle";
+    PlayerStepResult step;
+    if (fixedPhysics) {
+        step = simulateStepFixed(map, fixedBody, moveDir, wantJump);
+        if (fixedBody.y > Fixed::fromInt(WINDOW_HEIGHT)) {
+            respawn();
+            nextClip = ANIM_PLAYER_FALL;
+        }
+        body.x = fixedBody.x.toFloat();
+        body.y = fixedBody.y.toFloat();
+        body.velX = fixedBody.velX.toFloat();
+        body.velY = fixedBody.velY.toFloat();
+        body.onGround = fixedBody.onGround;
     }
     else {
-        if (justJumped) {
-            currentAnim = "jump";
-        }
-        else if (velY > GRAVITY * 1.1f) {
-            currentAnim = "fall";
-        }
-        else if (velY < -GRAVITY * 1.1f && currentAnim != "jump") {
-            currentAnim = "jump";
+        step = simulateStep(map, body, moveDir, wantJump);
+        if (body.y > WINDOW_HEIGHT) {
+            respawn();
+            nextClip = ANIM_PLAYER_FALL;
         }
     }
-    justJumped = false;
-
-    if (currentAnim != previousAnim) {
-        frame = 0;
-        frameCount = 0;
-        if (animations.count(currentAnim)) {
-            Animation& newAnim = animations[currentAnim];
-            dstRect.w = newAnim.frameW * playerScale;
-            dstRect.h = newAnim.frameH * playerScale;
-        }
+    if (step.jumped) {
+        jumpQueuedTicks = 0;
+        coyoteSpent = true;
     }
-
-    // Animation Frame Update
-    if (animations.count(currentAnim)) {
-        Animation& anim = animations[currentAnim];
-        if (anim.frames > 1) {
-            frameCount++;
-            if (frameCount >= frameDelay) {
-                frame = (frame + 1) % anim.frames;
-                frameCount = 0;
-            }
-        }
-        else {
-            frame = 0;
-        }
-        srcRect.x = frame * anim.frameW;
-        srcRect.y = 0;
-        srcRect.w = anim.frameW;
-        srcRect.h = anim.frameH;
+    else if (jumpQueuedTicks > 0) {
+        --jumpQueuedTicks;
+    }
+    if (body.onGround) {
+        ticksSinceGround = 0;
+        coyoteSpent = false;
     }
     else {
-        printf("Warning: Animation '%s' not found!\n", currentAnim.c_str());
-        srcRect = { 0, 0, 32, 32 };
+        ++ticksSinceGround;
     }
 
-    dstRect.x = static_cast<int>(x);
-    dstRect.y = static_cast<int>(y);
-}
-
-void Player::render(SDL_Renderer* renderer) {
-    if (!renderer) return;
+    justJumped = step.jumped;
+    justLanded = step.landed;
+    if (step.landed) {
+        landingSpeed = step.landingSpeed;
+    }
 
-    if (animations.count(currentAnim)) {
-        Animation& anim = animations[currentAnim];
-        if (anim.texture) {
-            SDL_RenderCopyEx(renderer, anim.texture, &srcRect, &dstRect, 0, nullptr, flip);
+    // Animation State; World advances the frames.
+    if (body.onGround) {
+        nextClip = isMovingHorizontally ? ANIM_PLAYER_RUN : ANIM_PLAYER_IDLE;
+    }
+    else {
+        if (justJumped) {
+            nextClip = ANIM_PLAYER_JUMP;
+        }
+        else if (body.velY > GRAVITY * 1.1f) {
+            nextClip = ANIM_PLAYER_FALL;
+        }
+        else if (body.velY < -GRAVITY * 1.1f) {
+            nextClip = ANIM_PLAYER_JUMP;
         }
     }
-
-}
\ No newline at end of file
+    justJumped = false;
+    world->playClip(entity, nextClip);
+    syncEntity();
+}
@@ -1,52 +1,106 @@
 ﻿#pragma once
 #include <SDL.h>
-#include <map>
-#include <string>
 #include "Constants.h"
+#include "Animation.h"
+#include "Fixed.h"
+#include "World.h"
 
 class Map;
 
+// Physics state of a player-sized body. Player and the reachability precompute
+// step it with the same code, so offline answers match what the game does.
+struct PlayerBody {
+    float x = 0.0f, y = 0.0f;
+    float velX = 0.0f, velY = 0.0f;
+    float w = 64.0f, h = 64.0f;
+    bool onGround = false;
+};
+
+// The same body in Q16.16 for deterministic runs (--deterministic). Stepped by
+// integer-only code, so a given input sequence always gives the same states.
+struct PlayerBodyFixed {
+    Fixed x{}, y{};
+    Fixed velX{}, velY{};
+    Fixed w = Fixed::fromInt(64), h = Fixed::fromInt(64);
+    bool onGround = false;
+};
+
+struct PlayerStepResult {
+    bool jumped = false;
+    bool landed = false;       // hit the floor faster than a resting contact
+    float landingSpeed = 0.0f;
+};
+
 class Player {
 public:
     Player();
     ~Player();
 
-    void init(SDL_Renderer* renderer);
+    // Creates the player's sprite entity in the world; World animates and draws it.
+    void init(World& gameWorld);
     void handleInput(const Uint8* keystate);
     void update(const Map& map);
-    void render(SDL_Renderer* renderer);
+    // One fixed physics tick: horizontal input (-1, 0, +1), jump, gravity, swept
+    // tile collision and the screen edges. Falling off the bottom is left to the caller.
+    static PlayerStepResult simulateStep(const Map& map, PlayerBody& body, int moveDir, bool jump);
+    // Fixed-point twin of simulateStep() on Map::sweepFixed(). With the current
+    // constants, all exact in Q16.16, it matches the float path state for state;
+    // other constants may round differently, so only fixed runs are compared.
+    static PlayerStepResult simulateStepFixed(const Map& map, PlayerBodyFixed& body, int moveDir, bool jump);
+    // Puts a body back at (x, y) at rest and airborne, as after falling off the map.
+    static void resetBody(PlayerBody& body, float x, float y);
+    static void resetBody(PlayerBodyFixed& body, float x, float y);
+    // Switches update() to the fixed-point body; the float body then only mirrors it.
+    void setFixedPhysics(bool enabled);
+    bool usesFixedPhysics() const { return fixedPhysics; }
+    // Where the player starts and respawns after falling off the map.
+    void setSpawn(float newSpawnX, float newSpawnY);
+    // Back to the spawn point at rest, as after falling off the map.
+    void respawn() { setSpawn(spawnX, spawnY); }
+    // Upward push from a fan: the body rises at least 'speed' px per tick.
+    void applyLift(int speed);
+    // Jump assists, in physics ticks (0 turns one off): a jump pressed up to
+    // bufferTicks before landing fires on landing, and one pressed up to
+    // graceTicks after walking off a ledge (coyote time) still leaves from the ledge.
+    void setJumpAssist(int bufferTicks, int graceTicks) { jumpBufferTicks = bufferTicks; coyoteTicks = graceTicks; }
 
-    float getX() const { return x; }
-    float getY() const { return y; }
-    const SDL_Rect& getDstRect() const { return dstRect; }
+    float getX() const { return body.x; }
+    float getY() const { return body.y; }
+    bool isOnGround() const { return body.onGround; }
+    // Collision box in whole pixels, taken from the fixed body when it is in use.
+    SDL_Rect getBounds() const;
+    // Mixes the simulation state (fixed body and jump assist counters) into an FNV-1a
+    // hash; the deterministic-run checksum uses it.
+    Uint64 hashState(Uint64 hash) const;
+    bool hasJustLanded() const { return justLanded; }
+    float getLandingSpeed() const { return landingSpeed; }
 
 
 private:
-    struct Animation {
-        SDL_Texture* texture = nullptr;
-        int frames = 0;
-        int frameW = 0;
-        int frameH = 0;
-    };
+    static const int PLAYER_SCALE = 2;
 
-    void loadAnimations(SDL_Renderer* renderer);
+    // Moves the sprite entity to the collision box.
+    void syncEntity();
 
-    float x, y;
-    float speed;
-    float velX, velY;
+    PlayerBody body;
+    PlayerBodyFixed fixedBody;
+    bool fixedPhysics;
+    float spawnX, spawnY;
+    int moveDir;
+    bool jumpPressed;       // jump key down this tick
+    bool jumpWasDown;       // ...and last tick, to spot new presses
+
+    int jumpBufferTicks;
+    int coyoteTicks;
+    int jumpQueuedTicks;    // ticks a new press stays usable
+    int ticksSinceGround;
+    bool coyoteSpent;       // set by a jump (or respawn, lift) until the next landing
 
-    bool onGround;
     bool isMovingHorizontally;
     bool justJumped;
-    int frame;
-    int frameDelay;
-    int frameCount;
-
-    std::string currentAnim;
-    SDL_RendererFlip flip;
-    SDL_Rect srcRect;
-    SDL_Rect dstRect;
-    int playerScale;
+    bool justLanded;
+    float landingSpeed;
 
-    std::map<std::string, Animation> animations;
+    World* world;
+    EntityId entity;
 };
\ No newline at end of file
@@ -0,0 +1,458 @@
+#include "ReachGraph.h"
+#include "Map.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+
+// Bump when the action set or the simulation rules change so old caches are rebuilt.
+static const Uint32 REACH_ALGORITHM_VERSION = 2;
+static const Uint32 REACH_MAGIC = 0x31484352;  // "RCH1"
+static const int MAX_SIM_TICKS = 600;
+
+// Horizontal hold lengths tried for each jump direction.
+static const Uint16 JUMP_HOLDS[] = { ReachGraph::HOLD_ALL, 4, 8, 16, 24 };
+
+const Uint16 ReachGraph::UNREACHABLE;
+const Uint16 ReachGraph::HOLD_ALL;
+const int ReachGraph::TICK_MS;
+
+struct ReachCacheHeader {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 inputHash;
+    Sint32 rows, cols, spawnCount;
+    Sint32 nodeCount, edgeCount, touchCount;
+};
+
+ReachGraph::ReachGraph() :
+    rows(0), cols(0), spawnCount(0),
+    bodyW(64.0f), bodyH(64.0f)
+{
+}
+
+static void fnvMix(Uint32& hash, const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+}
+
+Uint32 ReachGraph::hashInputs(const Map& map, float w, float h) const {
+    Uint32 hash = 2166136261u;
+    const float physics[] = { GRAVITY, JUMP_FORCE, MOVE_SPEED, w, h };
+    const int layout[] = { map.getRows(), map.getCols(), WINDOW_WIDTH, WINDOW_HEIGHT,
+                           TILE_WIDTH * TILE_SCALE, TILE_HEIGHT * TILE_SCALE, TICK_MS };
+    fnvMix(hash, &REACH_ALGORITHM_VERSION, sizeof(REACH_ALGORITHM_VERSION));
+    fnvMix(hash, physics, sizeof(physics));
+    fnvMix(hash, layout, sizeof(layout));
+    for (int row = 0; row < map.getRows(); ++row) {
+        for (int col = 0; col < map.getCols(); ++col) {
+            Uint8 cell = (map.getTile(row, col) != 0) | (map.isCellBlocked(row, col) << 1);
+            fnvMix(hash, &cell, 1);
+        }
+    }
+    const std::vector<SpawnPoint>& spawnPoints = map.getCollectibleSpawns();
+    if (!spawnPoints.empty()) {
+        fnvMix(hash, spawnPoints.data(), spawnPoints.size() * sizeof(SpawnPoint));
+    }
+    return hash;
+}
+
+bool ReachGraph::loadOrBuild(const Map& map, const std::string& cachePath, float w, float h) {
+    Uint32 inputHash = hashInputs(map, w, h);
+    bodyW = w;
+    bodyH = h;
+    if (loadCache(map, cachePath, inputHash)) {
+        printf("Reachability loaded from %s (%d nodes, %d edges)\n", cachePath.c_str(),
+               getNodeCount(), static_cast<int>(edges.size()));
+        return true;
+    }
+
+    Uint32 start = SDL_GetTicks();
+    build(map, w, h);
+    printf("Reachability built in %u ms (%d nodes, %d edges, %d touches)\n", SDL_GetTicks() - start,
+           getNodeCount(), static_cast<int>(edges.size()), static_cast<int>(touches.size()));
+    saveCache(cachePath, inputHash);
+    return !nodes.empty();
+}
+
+void ReachGraph::indexNodes(const Map& map) {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    rows = map.getRows();
+    cols = map.getCols();
+    nodes.clear();
+    nodeIndex.assign(static_cast<size_t>(rows) * cols, -1);
+    for (int row = 0; row + 1 < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            if (col * tilePixelW + bodyW > WINDOW_WIDTH) break;
+            // Nobody should plan to stand where a hazard sweeps.
+            if (map.getTile(row, col) == 0 && map.getTile(row + 1, col) != 0 && !map.isCellBlocked(row, col)) {
+                nodeIndex[row * cols + col] = static_cast<Sint16>(nodes.size());
+                ReachNode node = { static_cast<Uint16>(col), static_cast<Uint16>(row) };
+                nodes.push_back(node);
+            }
+        }
+    }
+}
+
+int ReachGraph::nodeAt(float x, float y) const {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+    int row = static_cast<int>(y + bodyH - 1) / tilePixelH;
+    if (x < 0 || y < 0 || row >= rows) return -1;
+
+    // Prefer the cell under the body's centre; a body hanging over an edge is
+    // standing on whichever side still has floor.
+    const int probes[3] = {
+        static_cast<int>(x + bodyW / 2) / tilePixelW,
+        static_cast<int>(x) / tilePixelW,
+        static_cast<int>(x + bodyW - 1) / tilePixelW
+    };
+    for (int i = 0; i < 3; ++i) {
+        if (probes[i] < cols && nodeIndex[row * cols + probes[i]] >= 0) {
+            return nodeIndex[row * cols + probes[i]];
+        }
+    }
+    return -1;
+}
+
+int ReachGraph::simulate(const Map& map, int from, const ReachAction& action, int& ticks,
+                         std::vector<Uint16>& touchTicks) const {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+
+    PlayerBody body;
+    body.w = bodyW;
+    body.h = bodyH;
+    body.x = static_cast<float>(nodes[from].col * tilePixelW);
+    body.y = (nodes[from].row + 1) * tilePixelH - bodyH;
+    body.onGround = true;
+
+    for (int tick = 0; tick <= MAX_SIM_TICKS; ++tick) {
+        if (tick > 0) {
+            int dir = (action.holdTicks == HOLD_ALL || tick <= action.holdTicks) ? action.dir : 0;
+            Player::simulateStep(map, body, dir, action.jump && tick == 1);
+        }
+
+        // Same integer overlap test the game uses for pickups.
+        SDL_Rect rect = { static_cast<int>(body.x), static_cast<int>(body.y),
+                          static_cast<int>(body.w), static_cast<int>(body.h) };
+        int colLo = rect.x / tilePixelW - 1, colHi = (rect.x + rect.w - 1) / tilePixelW;
+        int rowLo = rect.y / tilePixelH - 1, rowHi = (rect.y + rect.h - 1) / tilePixelH;
+        for (int row = rowLo < 0 ? 0 : rowLo; row <= rowHi && row < rows; ++row) {
+            for (int col = colLo < 0 ? 0 : colLo; col <= colHi && col < cols; ++col) {
+                const std::vector<Uint16>& cell = spawnGrid[row * cols + col];
+                for (size_t i = 0; i < cell.size(); ++i) {
+                    const SDL_Rect& spawn = spawnRects[cell[i]];
+                    if (rect.x < spawn.x + spawn.w && rect.x + rect.w > spawn.x &&
+                        rect.y < spawn.y + spawn.h && rect.y + rect.h > spawn.y &&
+                        tick < touchTicks[cell[i]]) {
+                        touchTicks[cell[i]] = static_cast<Uint16>(tick);
+                    }
+                }
+            }
+        }
+
+        if (tick == 0) continue;
+        if (body.y > WINDOW_HEIGHT) return -1;
+        if (!body.onGround) continue;
+
+        ticks = tick;
+        int at = nodeAt(body.x, body.y);
+        if (action.jump) return at;                     // a jump ends at its first landing
+        if (at >= 0 && at != from) return at;
+        if (body.velX == 0.0f) return -1;               // walked into a wall or the screen edge
+    }
+    return -1;
+}
+
+void ReachGraph::build(const Map& map, float w, float h) {
+    const int tilePixelW = TILE_WIDTH * TILE_SCALE;
+    const int tilePixelH = TILE_HEIGHT * TILE_SCALE;
+    bodyW = w;
+    bodyH = h;
+    indexNodes(map);
+
+    const std::vector<SpawnPoint>& spawnPoints = map.getCollectibleSpawns();
+    spawnCount = static_cast<int>(spawnPoints.size());
+    spawnRects.resize(spawnCount);
+    spawnGrid.assign(static_cast<size_t>(rows) * cols, std::vector<Uint16>());
+    for (int s = 0; s < spawnCount; ++s) {
+        SDL_Rect rect = { spawnPoints[s].x, spawnPoints[s].y, tilePixelW, tilePixelH };
+        spawnRects[s] = rect;
+        int col = rect.x / tilePixelW, row = rect.y / tilePixelH;
+        if (col >= 0 && col < cols && row >= 0 && row < rows) {
+            spawnGrid[row * cols + col].push_back(static_cast<Uint16>(s));
+        }
+    }
+
+    std::vector<ReachAction> actions;
+    for (int dir = -1; dir <= 1; dir += 2) {
+        ReachAction walk = { 0, static_cast<Sint8>(dir), HOLD_ALL };
+        actions.push_back(walk);
+    }
+    ReachAction jumpUp = { 1, 0, HOLD_ALL };
+    actions.push_back(jumpUp);
+    for (int dir = -1; dir <= 1; dir += 2) {
+        for (size_t i = 0; i < sizeof(JUMP_HOLDS) / sizeof(JUMP_HOLDS[0]); ++i) {
+            ReachAction jump = { 1, static_cast<Sint8>(dir), JUMP_HOLDS[i] };
+            actions.push_back(jump);
+        }
+    }
+
+    const int nodeCount = getNodeCount();
+    edges.clear();
+    touches.clear();
+    std::vector<int> bestEdge(nodeCount, -1);
+    std::vector<Uint16> bestTouch(spawnCount), touchTicks(spawnCount);
+    std::vector<ReachAction> touchAction(spawnCount);
+    for (int from = 0; from < nodeCount; ++from) {
+        size_t firstEdge = edges.size();
+        std::fill(bestTouch.begin(), bestTouch.end(), UNREACHABLE);
+
+        for (size_t a = 0; a < actions.size(); ++a) {
+            std::fill(touchTicks.begin(), touchTicks.end(), UNREACHABLE);
+            int ticks = 0;
+            int to = simulate(map, from, actions[a], ticks, touchTicks);
+
+            if (to >= 0 && to != from) {
+                int existing = bestEdge[to];
+                if (existing < 0) {
+                    bestEdge[to] = static_cast<int>(edges.size());
+                    ReachEdge edge = { static_cast<Uint16>(from), static_cast<Uint16>(to),
+                                       static_cast<Uint16>(ticks), actions[a] };
+                    edges.push_back(edge);
+                }
+                else if (ticks < edges[existing].ticks) {
+                    edges[existing].ticks = static_cast<Uint16>(ticks);
+                    edges[existing].action = actions[a];
+                }
+            }
+            for (int s = 0; s < spawnCount; ++s) {
+                if (touchTicks[s] < bestTouch[s]) {
+                    bestTouch[s] = touchTicks[s];
+                    touchAction[s] = actions[a];
+                }
+            }
+        }
+
+        for (size_t e = firstEdge; e < edges.size(); ++e) {
+            bestEdge[edges[e].to] = -1;
+        }
+        for (int s = 0; s < spawnCount; ++s) {
+            if (bestTouch[s] != UNREACHABLE) {
+                ReachTouch touch = { static_cast<Uint16>(from), static_cast<Uint16>(s), bestTouch[s], touchAction[s] };
+                touches.push_back(touch);
+            }
+        }
+    }
+
+    if (edges.size() >= UNREACHABLE || touches.size() >= UNREACHABLE || nodeCount >= UNREACHABLE) {
+        printf("Reachability graph too large (%d nodes, %d edges); ignoring it\n", nodeCount, static_cast<int>(edges.size()));
+        nodes.clear();
+        edges.clear();
+        touches.clear();
+    }
+    finishLoad();
+    solve();
+}
+
+void ReachGraph::solve() {
+    const int nodeCount = getNodeCount();
+    dist.assign(static_cast<size_t>(nodeCount) * nodeCount, UNREACHABLE);
+    nextHop.assign(static_cast<size_t>(nodeCount) * nodeCount, UNREACHABLE);
+
+    // Dijkstra from every node; edge weights are ticks.
+    typedef std::pair<Uint32, int> QueueEntry;
+    std::vector<Uint32> best(nodeCount);
+    std::vector<Uint16> first(nodeCount);
+    for (int source = 0; source < nodeCount; ++source) {
+        std::fill(best.begin(), best.end(), 0xFFFFFFFFu);
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+        best[source] = 0;
+        first[source] = UNREACHABLE;
+        open.push(QueueEntry(0, source));
+        while (!open.empty()) {
+            QueueEntry top = open.top();
+            open.pop();
+            int node = top.second;
+            if (top.first != best[node]) continue;
+            for (int e = edgeStart[node]; e < edgeStart[node + 1]; ++e) {
+                Uint32 cost = top.first + edges[e].ticks;
+                int to = edges[e].to;
+                if (cost < best[to]) {
+                    best[to] = cost;
+                    first[to] = node == source ? static_cast<Uint16>(e) : first[node];
+                    open.push(QueueEntry(cost, to));
+                }
+            }
+        }
+        for (int to = 0; to < nodeCount; ++to) {
+            if (best[to] >= UNREACHABLE) continue;
+            dist[source * nodeCount + to] = static_cast<Uint16>(best[to]);
+            nextHop[source * nodeCount + to] = first[to];
+        }
+    }
+
+    // Time to touch each spawn: travel to some node, then do that node's touching action.
+    spawnTime.assign(static_cast<size_t>(nodeCount) * spawnCount, UNREACHABLE);
+    spawnVia.assign(static_cast<size_t>(nodeCount) * spawnCount, UNREACHABLE);
+    for (int source = 0; source < nodeCount; ++source) {
+        Uint16* times = spawnTime.data() + static_cast<size_t>(source) * spawnCount;
+        Uint16* via = spawnVia.data() + static_cast<size_t>(source) * spawnCount;
+        for (int node = 0; node < nodeCount; ++node) {
+            Uint32 travel = dist[source * nodeCount + node];
+            if (travel == UNREACHABLE) continue;
+            for (int t = touchStart[node]; t < touchStart[node + 1]; ++t) {
+                Uint32 total = travel + touches[t].ticks;
+                if (total < times[touches[t].spawn]) {
+                    times[touches[t].spawn] = static_cast<Uint16>(total);
+                    via[touches[t].spawn] = static_cast<Uint16>(t);
+                }
+            }
+        }
+    }
+}
+
+void ReachGraph::finishLoad() {
+    const int nodeCount = getNodeCount();
+    edgeStart.assign(nodeCount + 1, 0);
+    for (size_t e = 0; e < edges.size(); ++e) ++edgeStart[edges[e].from + 1];
+    touchStart.assign(nodeCount + 1, 0);
+    for (size_t t = 0; t < touches.size(); ++t) ++touchStart[touches[t].node + 1];
+    for (int n = 0; n < nodeCount; ++n) {
+        edgeStart[n + 1] += edgeStart[n];
+        touchStart[n + 1] += touchStart[n];
+    }
+    reachableSpawns.assign(nodeCount, std::vector<Uint16>());
+}
+
+void ReachGraph::setSpawnTimeLimit(Uint32 limitMs) {
+    Uint32 limitTicks = limitMs / TICK_MS;
+    for (int node = 0; node < getNodeCount(); ++node) {
+        std::vector<Uint16>& list = reachableSpawns[node];
+        list.clear();
+        for (int s = 0; s < spawnCount; ++s) {
+            if (spawnTicks(node, s) <= limitTicks) {
+                list.push_back(static_cast<Uint16>(s));
+            }
+        }
+    }
+}
+
+template <typename T>
+static bool readArray(std::ifstream& in, std::vector<T>& out, size_t count) {
+    out.resize(count);
+    if (count) in.read(reinterpret_cast<char*>(out.data()), count * sizeof(T));
+    return static_cast<bool>(in);
+}
+
+template <typename T>
+static void writeArray(std::ofstream& out, const std::vector<T>& data) {
+    if (!data.empty()) out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+}
+
+bool ReachGraph::loadCache(const Map& map, const std::string& path, Uint32 inputHash) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    const Uint64 fileSize = static_cast<Uint64>(in.tellg());
+    in.seekg(0);
+    ReachCacheHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || header.magic != REACH_MAGIC || header.version != REACH_ALGORITHM_VERSION ||
+        header.inputHash != inputHash) {
+        printf("Reachability cache %s is stale, rebuilding\n", path.c_str());
+        return false;
+    }
+
+    // The hash says the inputs match, but the counts below size every allocation,
+    // so check them against the map before trusting any of them.
+    const Sint32 mapSpawns = static_cast<Sint32>(map.getCollectibleSpawns().size());
+    if (header.rows != map.getRows() || header.cols != map.getCols() || header.spawnCount != mapSpawns ||
+        header.nodeCount < 0 || header.nodeCount > header.rows * header.cols || header.nodeCount >= UNREACHABLE ||
+        header.edgeCount < 0 || header.edgeCount >= UNREACHABLE ||
+        header.touchCount < 0 || header.touchCount >= UNREACHABLE) {
+        printf("Reachability cache %s does not match the level, rebuilding\n", path.c_str());
+        return false;
+    }
+    const Uint64 nodeCount = static_cast<Uint64>(header.nodeCount);
+    const Uint64 expectedSize = sizeof(header) + nodeCount * sizeof(ReachNode) +
+                                static_cast<Uint64>(header.edgeCount) * sizeof(ReachEdge) +
+                                static_cast<Uint64>(header.touchCount) * sizeof(ReachTouch) +
+                                2 * nodeCount * nodeCount * sizeof(Uint16) +
+                                2 * nodeCount * header.spawnCount * sizeof(Uint16);
+    if (fileSize != expectedSize) {
+        printf("Reachability cache %s is %llu bytes, expected %llu; rebuilding\n", path.c_str(),
+               static_cast<unsigned long long>(fileSize), static_cast<unsigned long long>(expectedSize));
+        return false;
+    }
+
+    rows = header.rows;
+    cols = header.cols;
+    spawnCount = header.spawnCount;
+    bool ok = readArray(in, nodes, nodeCount) &&
+              readArray(in, edges, header.edgeCount) &&
+              readArray(in, touches, header.touchCount) &&
+              readArray(in, dist, nodeCount * nodeCount) &&
+              readArray(in, nextHop, nodeCount * nodeCount) &&
+              readArray(in, spawnTime, nodeCount * spawnCount) &&
+              readArray(in, spawnVia, nodeCount * spawnCount);
+    if (!ok || !cacheIndicesValid()) {
+        printf("Reachability cache %s is %s, rebuilding\n", path.c_str(), ok ? "corrupt" : "truncated");
+        nodes.clear();
+        edges.clear();
+        touches.clear();
+        return false;
+    }
+
+    nodeIndex.assign(static_cast<size_t>(rows) * cols, -1);
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        nodeIndex[nodes[n].row * cols + nodes[n].col] = static_cast<Sint16>(n);
+    }
+    finishLoad();
+    return true;
+}
+
+bool ReachGraph::cacheIndicesValid() const {
+    const int nodeCount = getNodeCount();
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        if (nodes[n].row + 1 >= rows || nodes[n].col >= cols) return false;
+    }
+    // finishLoad() builds its offsets assuming edges and touches are grouped by node.
+    for (size_t e = 0; e < edges.size(); ++e) {
+        if (edges[e].from >= nodeCount || edges[e].to >= nodeCount) return false;
+        if (e > 0 && edges[e].from < edges[e - 1].from) return false;
+    }
+    for (size_t t = 0; t < touches.size(); ++t) {
+        if (touches[t].node >= nodeCount || touches[t].spawn >= spawnCount) return false;
+        if (t > 0 && touches[t].node < touches[t - 1].node) return false;
+    }
+    for (size_t i = 0; i < nextHop.size(); ++i) {
+        if (nextHop[i] != UNREACHABLE && nextHop[i] >= edges.size()) return false;
+    }
+    for (size_t i = 0; i < spawnVia.size(); ++i) {
+        if (spawnVia[i] != UNREACHABLE && spawnVia[i] >= touches.size()) return false;
+    }
+    return true;
+}
+
+void ReachGraph::saveCache(const std::string& path, Uint32 inputHash) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        printf("Could not write reachability cache %s\n", path.c_str());
+        return;
+    }
+    ReachCacheHeader header = { REACH_MAGIC, REACH_ALGORITHM_VERSION, inputHash, rows, cols, spawnCount,
+                                getNodeCount(), static_cast<Sint32>(edges.size()), static_cast<Sint32>(touches.size()) };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeArray(out, nodes);
+    writeArray(out, edges);
+    writeArray(out, touches);
+    writeArray(out, dist);
+    writeArray(out, nextHop);
+    writeArray(out, spawnTime);
+    writeArray(out, spawnVia);
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "Player.h"
+
+class Map;
+
+// What a player (or bot) does to follow an edge: optionally jump on the first
+// tick, then hold a horizontal direction for holdTicks ticks (or the whole move).
+struct ReachAction {
+    Uint8 jump;
+    Sint8 dir;
+    Uint16 holdTicks;
+};
+
+// Standing spot: the body rests in cell (col, row) on the tile below it.
+struct ReachNode {
+    Uint16 col, row;
+};
+
+struct ReachEdge {
+    Uint16 from, to;
+    Uint16 ticks;
+    ReachAction action;
+};
+
+// Doing 'action' from 'node' overlaps collectible spawn 'spawn' after 'ticks'.
+struct ReachTouch {
+    Uint16 node, spawn;
+    Uint16 ticks;
+    ReachAction action;
+};
+
+// Which standing spots reach which others by walking, falling or jumping,
+// found by running Player::simulateStep offline from every spot. All-pairs
+// travel times, next hops and time-to-spawn tables are precomputed, so every
+// query is a table lookup. Tables are N*N (nodes) and N*S (spawn cells); the
+// result is cached next to the level and rebuilt when the map or physics change.
+class ReachGraph {
+public:
+    static const Uint16 UNREACHABLE = 0xFFFF;
+    static const Uint16 HOLD_ALL = 0xFFFF;
+    static const int TICK_MS = 1000 / 60;   // Player physics runs once per 60 Hz frame
+
+    ReachGraph();
+
+    // Loads cachePath if it matches the map and physics, otherwise rebuilds and rewrites it.
+    bool loadOrBuild(const Map& map, const std::string& cachePath, float w, float h);
+    void build(const Map& map, float w, float h);
+    // Precomputes, per node, the spawn cells reachable within limitMs.
+    void setSpawnTimeLimit(Uint32 limitMs);
+
+    int getNodeCount() const { return static_cast<int>(nodes.size()); }
+    const ReachNode& getNode(int node) const { return nodes[node]; }
+    // Node the body is standing on, or -1. Only meaningful while the body is on the ground.
+    int nodeAt(float x, float y) const;
+
+    const ReachEdge* edgesFrom(int node, int& count) const {
+        count = edgeStart[node + 1] - edgeStart[node];
+        return edges.data() + edgeStart[node];
+    }
+    const ReachTouch* touchesFrom(int node, int& count) const {
+        count = touchStart[node + 1] - touchStart[node];
+        return touches.data() + touchStart[node];
+    }
+    Uint16 travelTicks(int from, int to) const { return dist[from * nodes.size() + to]; }
+    // First edge on the fastest route, or -1 when 'to' is unreachable or equal to 'from'.
+    int nextEdge(int from, int to) const { return nextHop[from * nodes.size() + to] == UNREACHABLE ? -1 : nextHop[from * nodes.size() + to]; }
+    const ReachEdge& getEdge(int edge) const { return edges[edge]; }
+
+    // Fastest time from a node to touching a spawn cell, and the touch that finishes it.
+    // Spawns the map added after the graph was built count as unreachable.
+    Uint16 spawnTicks(int node, int spawn) const { return spawn < spawnCount ? spawnTime[node * spawnCount + spawn] : UNREACHABLE; }
+    int spawnTouch(int node, int spawn) const {
+        if (spawn >= spawnCount || spawnVia[node * spawnCount + spawn] == UNREACHABLE) return -1;
+        return spawnVia[node * spawnCount + spawn];
+    }
+    const ReachTouch& getTouch(int touch) const { return touches[touch]; }
+    const std::vector<Uint16>& spawnsWithinLimit(int node) const { return reachableSpawns[node]; }
+
+private:
+    Uint32 hashInputs(const Map& map, float w, float h) const;
+    void indexNodes(const Map& map);
+    // Runs one action from a node; returns the node it ends standing on (or -1) and the
+    // ticks taken, and lowers touchTicks[s] for every spawn cell the body overlapped.
+    int simulate(const Map& map, int from, const ReachAction& action, int& ticks,
+                 std::vector<Uint16>& touchTicks) const;
+    void solve();
+    void finishLoad();
+    // Refuses (so the caller rebuilds) a cache whose header does not match the map, whose
+    // size disagrees with its header, or whose indices point outside their arrays.
+    bool loadCache(const Map& map, const std::string& path, Uint32 inputHash);
+    bool cacheIndicesValid() const;
+    void saveCache(const std::string& path, Uint32 inputHash) const;
+
+    int rows, cols, spawnCount;
+    float bodyW, bodyH;
+    std::vector<Sint16> nodeIndex;       // rows * cols, -1 when the cell is not a standing spot
+    std::vector<ReachNode> nodes;
+    std::vector<ReachEdge> edges;        // sorted by 'from'
+    std::vector<int> edgeStart;          // nodes + 1 offsets into edges
+    std::vector<ReachTouch> touches;     // sorted by 'node'
+    std::vector<int> touchStart;
+    std::vector<Uint16> dist;            // nodes * nodes ticks
+    std::vector<Uint16> nextHop;         // nodes * nodes edge index
+    std::vector<Uint16> spawnTime;       // nodes * spawns ticks
+    std::vector<Uint16> spawnVia;        // nodes * spawns touch index
+    std::vector<std::vector<Uint16>> reachableSpawns;
+
+    // Build-time only: spawn rects bucketed by the cell of their top-left corner.
+    std::vector<SDL_Rect> spawnRects;
+    std::vector<std::vector<Uint16>> spawnGrid;
+};
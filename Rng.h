@@ -0,0 +1,42 @@
+#pragma once
+#include <SDL.h>
+
+// PCG32 (pcg-random.org): 8 bytes of state, one multiply-add and a rotate per
+// draw. Small enough to copy into anything that needs its own reproducible stream.
+class Rng {
+public:
+    explicit Rng(Uint64 seed = 0x853C49E6748FEA9BULL) { reseed(seed); }
+
+    void reseed(Uint64 newSeed) {
+        seed = newSeed;
+        state = 0;
+        next();
+        state += newSeed;
+        next();
+    }
+    Uint64 getSeed() const { return seed; }
+    Uint64 getState() const { return state; }
+
+    Uint32 next() {
+        Uint64 old = state;
+        state = old * 6364136223846793005ULL + 1442695040888963407ULL;
+        Uint32 xorshifted = static_cast<Uint32>(((old >> 18) ^ old) >> 27);
+        Uint32 rot = static_cast<Uint32>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Uniform in [0, bound) by multiply-shift instead of a modulo; the bias is
+    // below bound / 2^32, far under anything a game can observe.
+    Uint32 below(Uint32 bound) {
+        return static_cast<Uint32>((static_cast<Uint64>(next()) * bound) >> 32);
+    }
+
+    // Uniform in [0, 1).
+    float nextFloat() {
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+private:
+    Uint64 seed;
+    Uint64 state;
+};
@@ -0,0 +1,105 @@
+#include "SoakLog.h"
+#include "TextureManager.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+const int SoakLog::HISTOGRAM_BUCKETS;
+
+SoakLog::SoakLog() :
+    file(nullptr),
+    intervalMs(60000),
+    startTime(0),
+    rowStart(0),
+    frames(0),
+    frameMsSum(0),
+    worstMs(0)
+{
+    memset(histogram, 0, sizeof(histogram));
+}
+
+SoakLog::~SoakLog() {
+    stop();
+}
+
+bool SoakLog::start(const std::string& path, Uint32 newIntervalMs) {
+    stop();
+    file = fopen(path.c_str(), "w");
+    if (!file) {
+        printf("Soak log: cannot open '%s' for writing\n", path.c_str());
+        return false;
+    }
+    intervalMs = newIntervalMs > 0 ? newIntervalMs : 60000;
+    startTime = rowStart = SDL_GetTicks();
+    frames = 0;
+    frameMsSum = 0;
+    worstMs = 0;
+    memset(histogram, 0, sizeof(histogram));
+    fprintf(file, "elapsed_s,frames,frame_avg_ms,frame_p99_ms,frame_max_ms,rss_kib,textures,texture_kib\n");
+    fflush(file);
+    printf("Soak log: writing to %s every %u s\n", path.c_str(), intervalMs / 1000);
+    return true;
+}
+
+void SoakLog::stop() {
+    if (!file) return;
+    if (frames > 0) writeRow(SDL_GetTicks());
+    fclose(file);
+    file = nullptr;
+}
+
+void SoakLog::recordFrame(Uint32 frameMs, Uint32 now) {
+    if (!file) return;
+    ++frames;
+    frameMsSum += frameMs;
+    if (frameMs > worstMs) worstMs = frameMs;
+    ++histogram[frameMs < HISTOGRAM_BUCKETS ? frameMs : HISTOGRAM_BUCKETS - 1];
+    if (now - rowStart >= intervalMs) writeRow(now);
+}
+
+void SoakLog::writeRow(Uint32 now) {
+    Uint32 p99 = 0;
+    Uint32 target = frames - frames / 100;
+    Uint32 seen = 0;
+    for (int ms = 0; ms < HISTOGRAM_BUCKETS; ++ms) {
+        seen += histogram[ms];
+        if (seen >= target) { p99 = ms; break; }
+    }
+    TextureStats textures = TextureManager::getTotalStats();
+    fprintf(file, "%u,%u,%.2f,%u,%u,%u,%d,%u\n",
+            (now - startTime) / 1000, frames,
+            frames ? static_cast<double>(frameMsSum) / frames : 0.0, p99, worstMs,
+            static_cast<unsigned>(residentKiB()), textures.resident,
+            static_cast<unsigned>(textures.bytes / 1024));
+    fflush(file);
+
+    rowStart = now;
+    frames = 0;
+    frameMsSum = 0;
+    worstMs = 0;
+    memset(histogram, 0, sizeof(histogram));
+}
+
+size_t SoakLog::residentKiB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize / 1024;
+    }
+    return 0;
+#else
+    // Second field of statm is the resident page count.
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    unsigned long totalPages = 0, residentPages = 0;
+    int fields = fscanf(statm, "%lu %lu", &totalPages, &residentPages);
+    fclose(statm);
+    if (fields != 2) return 0;
+    return residentPages * (static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024);
+#endif
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <SDL.h>
+#include <cstdio>
+#include <string>
+
+// Trend log for long unattended runs (--soak-log <file>). Collects frame times
+// and, every intervalMs, appends one CSV row: elapsed seconds, frames, average,
+// 99th percentile and worst frame time, resident memory, and the texture
+// manager's resident count and bytes. Rows are flushed as written, so a run
+// that dies overnight still leaves everything up to its last interval.
+class SoakLog {
+public:
+    SoakLog();
+    ~SoakLog();
+
+    bool start(const std::string& path, Uint32 intervalMs);
+    void stop();
+
+    // Call once per frame with the frame's duration; now is SDL_GetTicks().
+    void recordFrame(Uint32 frameMs, Uint32 now);
+
+    bool isActive() const { return file != nullptr; }
+
+    // Resident set size of this process in KiB, or 0 where it cannot be read.
+    static size_t residentKiB();
+
+private:
+    void writeRow(Uint32 now);
+
+    // Frame times bucketed per ms; the last bucket collects everything slower.
+    static const int HISTOGRAM_BUCKETS = 256;
+
+    FILE* file;
+    Uint32 intervalMs;
+    Uint32 startTime;
+    Uint32 rowStart;
+    Uint32 frames;
+    Uint64 frameMsSum;
+    Uint32 worstMs;
+    Uint32 histogram[HISTOGRAM_BUCKETS];
+};
@@ -0,0 +1,148 @@
+#include "SpatialHash.h"
+#include <algorithm>
+
+SpatialHash::SpatialHash(int cellSize, int bucketCount) :
+    cellSize(cellSize > 0 ? cellSize : 128),
+    queryStamp(0)
+{
+    int size = 1;
+    while (size < bucketCount) size <<= 1;
+    bucketMask = size - 1;
+    buckets.resize(size);
+}
+
+int SpatialHash::cellOf(int coord) const {
+    // Floor division, so boxes left of or above the origin land in negative cells.
+    return coord >= 0 ? coord / cellSize : -((-coord + cellSize - 1) / cellSize);
+}
+
+int SpatialHash::bucketOf(int cellX, int cellY) const {
+    Uint32 h = static_cast<Uint32>(cellX) * 73856093u ^ static_cast<Uint32>(cellY) * 19349663u;
+    return static_cast<int>(h & static_cast<Uint32>(bucketMask));
+}
+
+int SpatialHash::insert(const SDL_Rect& box, Uint32 layer, int userData) {
+    int id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else {
+        id = static_cast<int>(bodies.size());
+        bodies.push_back(Body());
+        visited.push_back(0);
+    }
+    Body& body = bodies[id];
+    body.box = box;
+    body.layer = layer ? layer : LAYER_ALL;
+    body.userData = userData;
+    link(id);
+    return id;
+}
+
+void SpatialHash::update(int id, const SDL_Rect& box) {
+    Body& body = bodies[id];
+    body.box = box;
+    int x0 = cellOf(box.x), y0 = cellOf(box.y);
+    int x1 = cellOf(box.x + box.w - 1), y1 = cellOf(box.y + box.h - 1);
+    if (x0 == body.cellX0 && y0 == body.cellY0 && x1 == body.cellX1 && y1 == body.cellY1) {
+        return;  // still in the same cells, only the box moved
+    }
+    unlink(id);
+    link(id);
+}
+
+void SpatialHash::remove(int id) {
+    if (id < 0 || id >= static_cast<int>(bodies.size()) || bodies[id].layer == 0) return;
+    unlink(id);
+    bodies[id].layer = 0;
+    freeIds.push_back(id);
+}
+
+void SpatialHash::clear() {
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        buckets[i].clear();
+    }
+    bodies.clear();
+    freeIds.clear();
+    visited.clear();
+}
+
+void SpatialHash::link(int id) {
+    Body& body = bodies[id];
+    body.cellX0 = cellOf(body.box.x);
+    body.cellY0 = cellOf(body.box.y);
+    body.cellX1 = cellOf(body.box.x + body.box.w - 1);
+    body.cellY1 = cellOf(body.box.y + body.box.h - 1);
+    for (int cy = body.cellY0; cy <= body.cellY1; ++cy) {
+        for (int cx = body.cellX0; cx <= body.cellX1; ++cx) {
+            std::vector<int>& bucket = buckets[bucketOf(cx, cy)];
+            // Distinct cells may share a bucket; file the body there only once.
+            if (bucket.empty() || bucket.back() != id) bucket.push_back(id);
+        }
+    }
+}
+
+void SpatialHash::unlink(int id) {
+    const Body& body = bodies[id];
+    for (int cy = body.cellY0; cy <= body.cellY1; ++cy) {
+        for (int cx = body.cellX0; cx <= body.cellX1; ++cx) {
+            std::vector<int>& bucket = buckets[bucketOf(cx, cy)];
+            for (size_t i = 0; i < bucket.size(); ++i) {
+                if (bucket[i] == id) {
+                    bucket[i] = bucket.back();
+                    bucket.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
+
+int SpatialHash::query(const SDL_Rect& box, Uint32 layerMask, std::vector<int>& out) const {
+    if (++queryStamp == 0) {
+        std::fill(visited.begin(), visited.end(), 0);
+        queryStamp = 1;
+    }
+    int found = 0;
+    int x0 = cellOf(box.x), y0 = cellOf(box.y);
+    int x1 = cellOf(box.x + box.w - 1), y1 = cellOf(box.y + box.h - 1);
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const std::vector<int>& bucket = buckets[bucketOf(cx, cy)];
+            for (size_t i = 0; i < bucket.size(); ++i) {
+                int id = bucket[i];
+                if (visited[id] == queryStamp) continue;
+                visited[id] = queryStamp;
+
+                const Body& body = bodies[id];
+                if (!(body.layer & layerMask)) continue;
+                if (box.x < body.box.x + body.box.w && box.x + box.w > body.box.x &&
+                    box.y < body.box.y + body.box.h && box.y + box.h > body.box.y) {
+                    out.push_back(id);
+                    ++found;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+int SpatialHash::queryPairs(Uint32 layerA, Uint32 layerB, std::vector<std::pair<int, int>>& out) const {
+    int found = 0;
+    for (int a = 0; a < static_cast<int>(bodies.size()); ++a) {
+        const Body& body = bodies[a];
+        if (!(body.layer & layerA)) continue;
+        pairHits.clear();
+        query(body.box, layerB, pairHits);
+        for (size_t i = 0; i < pairHits.size(); ++i) {
+            int b = pairHits[i];
+            if (b == a) continue;
+            // Both bodies qualify for both sides: keep only the (low, high) ordering.
+            if (b < a && (bodies[b].layer & layerA) && (body.layer & layerB)) continue;
+            out.push_back(std::make_pair(a, b));
+            ++found;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include <utility>
+
+// Broadphase for moving entities: a uniform grid of square cells hashed into a
+// fixed bucket table, so the world needs no bounds. Each body remembers the cell
+// range it was filed under; update() only touches buckets when that range changes.
+class SpatialHash {
+public:
+    enum Layer : Uint32 {
+        LAYER_PLAYER      = 1u << 0,
+        LAYER_COLLECTIBLE = 1u << 1,
+        LAYER_HAZARD      = 1u << 2,
+        LAYER_ENEMY       = 1u << 3,
+        LAYER_ALL         = 0xFFFFFFFFu
+    };
+
+    // cellSize should be about the size of a typical body; bucketCount is rounded up to a power of two.
+    explicit SpatialHash(int cellSize = 128, int bucketCount = 4096);
+
+    // Returns a body id, stable until remove(). userData is handed back by getUserData().
+    int insert(const SDL_Rect& box, Uint32 layer, int userData = 0);
+    void update(int id, const SDL_Rect& box);
+    void remove(int id);
+    void clear();
+
+    // Appends the ids of bodies in layerMask whose boxes overlap 'box'; each id appears once.
+    int query(const SDL_Rect& box, Uint32 layerMask, std::vector<int>& out) const;
+    // Appends every overlapping (a, b) pair with a in layerA and b in layerB; a pair is
+    // reported once even when both bodies are in both layers.
+    int queryPairs(Uint32 layerA, Uint32 layerB, std::vector<std::pair<int, int>>& out) const;
+
+    const SDL_Rect& getBox(int id) const { return bodies[id].box; }
+    Uint32 getLayer(int id) const { return bodies[id].layer; }
+    int getUserData(int id) const { return bodies[id].userData; }
+    void setUserData(int id, int userData) { bodies[id].userData = userData; }
+    int getBodyCount() const { return static_cast<int>(bodies.size() - freeIds.size()); }
+
+private:
+    struct Body {
+        SDL_Rect box;
+        Uint32 layer = 0;     // 0 marks a free id
+        int userData = 0;
+        int cellX0 = 0, cellY0 = 0, cellX1 = -1, cellY1 = -1;
+    };
+
+    int cellOf(int coord) const;
+    int bucketOf(int cellX, int cellY) const;
+    void link(int id);
+    void unlink(int id);
+
+    int cellSize;
+    int bucketMask;
+    std::vector<std::vector<int>> buckets;
+    std::vector<Body> bodies;
+    std::vector<int> freeIds;
+
+    // Per-body stamp so a body filed under several cells is reported once per query.
+    mutable std::vector<Uint32> visited;
+    mutable Uint32 queryStamp;
+    // queryPairs() scratch, kept so pair queries do not allocate once warmed up.
+    mutable std::vector<int> pairHits;
+};
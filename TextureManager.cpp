@@ -1,22 +1,217 @@
 #include "TextureManager.h"
 
-std::map<std::string, SDL_Texture*> TextureManager::textureCache;
+int TextureManager::assetSlots[ASSET_COUNT];
+std::vector<TextureManager::Slot> TextureManager::slots;
+std::vector<Uint16> TextureManager::freeSlots;
+int TextureManager::lruHead = -1;
+int TextureManager::lruTail = -1;
+size_t TextureManager::memoryBudget = 64 * 1024 * 1024;
+TextureStats TextureManager::categoryStats[TEXTURE_CATEGORY_COUNT];
 
-SDL_Texture* TextureManager::loadTexture(const std::string& path, SDL_Renderer* renderer) {
-    auto it = textureCache.find(path);
-    if (it != textureCache.end()) {
-        return it->second;
+TextureHandle TextureManager::acquire(const std::string& path, SDL_Renderer* renderer, TextureCategory category) {
+    AssetId asset = findAsset(path.c_str());
+    if (asset == INVALID_ASSET) {
+        printf("Texture '%s' is not in the asset manifest\n", path.c_str());
+        return TextureHandle();
+    }
+    return acquire(asset, renderer, category);
+}
+
+TextureHandle TextureManager::acquire(AssetId asset, SDL_Renderer* renderer, TextureCategory category) {
+    return acquireFromSurface(asset, nullptr, renderer, category);
+}
+
+TextureHandle TextureManager::acquireFromSurface(AssetId asset, SDL_Surface* decoded, SDL_Renderer* renderer, TextureCategory category) {
+    TextureHandle handle;
+    if (asset >= ASSET_COUNT) return handle;
+
+    int index = assetSlots[asset] - 1;
+    if (index >= 0) {
+        Slot& slot = slots[index];
+        if (slot.refCount++ == 0) {
+            lruUnlink(index);
+            ++categoryStats[slot.category].referenced;
+        }
+        handle.slot = static_cast<Uint16>(index);
+        handle.generation = slot.generation;
+        return handle;
     }
 
-    SDL_Texture* texture = IMG_LoadTexture(renderer, path.c_str());
+    const char* path = ASSET_MANIFEST[asset].path;
+    SDL_Texture* texture = decoded ? SDL_CreateTextureFromSurface(renderer, decoded)
+                                   : IMG_LoadTexture(renderer, path);
     if (texture == nullptr) {
-        printf("Unable to load texture '%s'! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
+        printf("Unable to load texture '%s'! SDL_image Error: %s\n", path, IMG_GetError());
+        return handle;
+    }
+    Uint32 format = 0;
+    int w = 0, h = 0;
+    SDL_QueryTexture(texture, &format, nullptr, &w, &h);
+    int bytesPerPixel = SDL_BYTESPERPIXEL(format);
+    if (bytesPerPixel <= 0) bytesPerPixel = 4;
+
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        index = static_cast<int>(slots.size());
+        slots.push_back(Slot());
+    }
+    Slot& slot = slots[index];
+    slot.texture = texture;
+    slot.asset = asset;
+    slot.refCount = 1;
+    slot.bytes = static_cast<size_t>(w) * h * bytesPerPixel;
+    slot.category = category;
+    assetSlots[asset] = index + 1;
+
+    TextureStats& stats = categoryStats[category];
+    ++stats.resident;
+    ++stats.referenced;
+    stats.bytes += slot.bytes;
+    printf("Loaded texture: %s (%u KB)\n", path, static_cast<unsigned>(slot.bytes / 1024));
+    enforceBudget();
+
+    handle.slot = static_cast<Uint16>(index);
+    handle.generation = slot.generation;
+    return handle;
+}
+
+TextureHandle TextureManager::addRef(TextureHandle handle) {
+    if (!get(handle) || slots[handle.slot].refCount <= 0) return TextureHandle();
+    ++slots[handle.slot].refCount;
+    return handle;
+}
+
+void TextureManager::release(TextureHandle& handle) {
+    if (get(handle)) {
+        Slot& slot = slots[handle.slot];
+        if (slot.refCount > 0 && --slot.refCount == 0) {
+            --categoryStats[slot.category].referenced;
+            lruPushBack(handle.slot);
+            enforceBudget();
+        }
+    }
+    handle = TextureHandle();
+}
+
+void TextureManager::setMemoryBudget(size_t bytes) {
+    memoryBudget = bytes;
+    enforceBudget();
+}
+
+void TextureManager::purgeUnreferenced() {
+    while (lruHead >= 0) {
+        freeSlot(lruHead);
+    }
+}
+
+void TextureManager::trackExternal(TextureCategory category, size_t bytes, bool created) {
+    TextureStats& stats = categoryStats[category];
+    if (created) {
+        ++stats.resident;
+        ++stats.referenced;
+        stats.bytes += bytes;
+        enforceBudget();
     }
     else {
-        printf("Loaded texture: %s\n", path.c_str());
-        textureCache[path] = texture;
+        --stats.resident;
+        --stats.referenced;
+        stats.bytes -= bytes;
     }
-    return texture;
+}
+
+void TextureManager::enforceBudget() {
+    if (memoryBudget == 0) return;
+    size_t total = getTotalStats().bytes;
+    while (total > memoryBudget && lruHead >= 0) {
+        total -= slots[lruHead].bytes;
+        freeSlot(lruHead);
+    }
+}
+
+void TextureManager::lruPushBack(int index) {
+    Slot& slot = slots[index];
+    slot.lruPrev = lruTail;
+    slot.lruNext = -1;
+    if (lruTail >= 0) slots[lruTail].lruNext = index;
+    else lruHead = index;
+    lruTail = index;
+}
+
+void TextureManager::lruUnlink(int index) {
+    Slot& slot = slots[index];
+    if (slot.lruPrev >= 0) slots[slot.lruPrev].lruNext = slot.lruNext;
+    else if (lruHead == index) lruHead = slot.lruNext;
+    if (slot.lruNext >= 0) slots[slot.lruNext].lruPrev = slot.lruPrev;
+    else if (lruTail == index) lruTail = slot.lruPrev;
+    slot.lruPrev = -1;
+    slot.lruNext = -1;
+}
+
+int TextureManager::getRefCount(TextureHandle handle) {
+    return get(handle) ? slots[handle.slot].refCount : 0;
+}
+
+int TextureManager::getLoadedCount() {
+    return static_cast<int>(slots.size() - freeSlots.size());
+}
+
+TextureStats TextureManager::getTotalStats() {
+    TextureStats total;
+    for (int c = 0; c < TEXTURE_CATEGORY_COUNT; ++c) {
+        total.resident += categoryStats[c].resident;
+        total.referenced += categoryStats[c].referenced;
+        total.bytes += categoryStats[c].bytes;
+    }
+    return total;
+}
+
+const char* TextureManager::getCategoryName(TextureCategory category) {
+    static const char* const names[TEXTURE_CATEGORY_COUNT] = {
+        "other", "ui", "background", "tileset", "character", "collectible", "trap", "effect"
+    };
+    return category < TEXTURE_CATEGORY_COUNT ? names[category] : "?";
+}
+
+void TextureManager::printStats() {
+    printf("Texture memory (budget %u KB):\n", static_cast<unsigned>(memoryBudget / 1024));
+    for (int c = 0; c < TEXTURE_CATEGORY_COUNT; ++c) {
+        const TextureStats& stats = categoryStats[c];
+        if (stats.resident == 0) continue;
+        printf("  %-12s %3d resident, %3d referenced, %6u KB\n", getCategoryName(static_cast<TextureCategory>(c)),
+               stats.resident, stats.referenced, static_cast<unsigned>(stats.bytes / 1024));
+    }
+    TextureStats total = getTotalStats();
+    printf("  %-12s %3d resident, %3d referenced, %6u KB\n", "total",
+           total.resident, total.referenced, static_cast<unsigned>(total.bytes / 1024));
+}
+
+void TextureManager::freeSlot(int index) {
+    Slot& slot = slots[index];
+    if (slot.texture) {
+        SDL_DestroyTexture(slot.texture);
+        printf("Unloaded texture: %s\n", getAssetPath(slot.asset));
+
+        TextureStats& stats = categoryStats[slot.category];
+        --stats.resident;
+        if (slot.refCount > 0) --stats.referenced;
+        stats.bytes -= slot.bytes;
+    }
+    if (slot.refCount == 0) {
+        lruUnlink(index);
+    }
+    if (slot.asset < ASSET_COUNT) {
+        assetSlots[slot.asset] = 0;
+    }
+    slot.texture = nullptr;
+    slot.asset = INVALID_ASSET;
+    slot.refCount = 0;
+    slot.bytes = 0;
+    // Bump the generation so any handle still pointing here goes stale.
+    if (++slot.generation == 0) slot.generation = 1;
+    freeSlots.push_back(static_cast<Uint16>(index));
 }
 
 void TextureManager::Draw(SDL_Renderer* renderer, SDL_Texture* tex, SDL_Rect src, SDL_Rect dest, SDL_RendererFlip flip) {
@@ -26,11 +221,11 @@ void TextureManager::Draw(SDL_Renderer* renderer, SDL_Texture* tex, SDL_Rect src
 
 void TextureManager::cleanUp() {
     printf("Cleaning up textures...\n");
-    for (auto& pair : textureCache) {
-        if (pair.second) {
-            SDL_DestroyTexture(pair.second);
+    printStats();
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].texture) {
+            freeSlot(static_cast<int>(i));
         }
     }
-    textureCache.clear();
     printf("Texture cleanup complete.\n");
-}
\ No newline at end of file
+}
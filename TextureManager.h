@@ -2,15 +2,103 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <string>
-#include <map>
+#include <vector>
 #include <cstdio>
+#include "AssetManifest.h"
+
+enum TextureCategory : Uint8 {
+    TEXTURE_CATEGORY_OTHER,
+    TEXTURE_CATEGORY_UI,
+    TEXTURE_CATEGORY_BACKGROUND,
+    TEXTURE_CATEGORY_TILESET,
+    TEXTURE_CATEGORY_CHARACTER,
+    TEXTURE_CATEGORY_COLLECTIBLE,
+    TEXTURE_CATEGORY_TRAP,
+    TEXTURE_CATEGORY_EFFECT,
+    TEXTURE_CATEGORY_COUNT
+};
+
+struct TextureStats {
+    int resident = 0;     // textures currently on the GPU
+    int referenced = 0;   // of those, how many have live handles
+    size_t bytes = 0;     // estimated GPU bytes (w * h * bytes per pixel)
+};
+
+// Generation-checked reference to a loaded texture. A handle whose slot has
+// been unloaded (or reused for another asset) resolves to nullptr.
+struct TextureHandle {
+    Uint16 slot = 0;
+    Uint16 generation = 0;  // 0 is never a live generation
+
+    bool isValid() const { return generation != 0; }
+};
 
 class TextureManager {
 private:
-    static std::map<std::string, SDL_Texture*> textureCache;
+    struct Slot {
+        SDL_Texture* texture = nullptr;
+        AssetId asset = INVALID_ASSET;
+        Uint16 generation = 1;
+        int refCount = 0;
+        size_t bytes = 0;
+        TextureCategory category = TEXTURE_CATEGORY_OTHER;
+        // Intrusive LRU list of resident but unreferenced slots (oldest at lruHead).
+        int lruPrev = -1;
+        int lruNext = -1;
+    };
+
+    static int assetSlots[ASSET_COUNT];  // AssetId -> slot index + 1, 0 when not loaded
+    static std::vector<Slot> slots;
+    static std::vector<Uint16> freeSlots;
+    static int lruHead, lruTail;
+    static size_t memoryBudget;
+    static TextureStats categoryStats[TEXTURE_CATEGORY_COUNT];
 
 public:
-    static SDL_Texture* loadTexture(const std::string& path, SDL_Renderer* renderer);
+    static const char* getAssetPath(AssetId asset) {
+        return asset < ASSET_COUNT ? ASSET_MANIFEST[asset].path : "";
+    }
+
+    // Loads the texture on first use (or after eviction), otherwise bumps its reference count.
+    // The path overload is for data-driven paths and must name a manifest entry exactly.
+    static TextureHandle acquire(AssetId asset, SDL_Renderer* renderer, TextureCategory category = TEXTURE_CATEGORY_OTHER);
+    static TextureHandle acquire(const std::string& path, SDL_Renderer* renderer, TextureCategory category = TEXTURE_CATEGORY_OTHER);
+    // Same as acquire(), but uploads a surface that was already decoded (e.g. on a loader thread).
+    // The caller keeps ownership of the surface.
+    static TextureHandle acquireFromSurface(AssetId asset, SDL_Surface* decoded, SDL_Renderer* renderer,
+                                            TextureCategory category = TEXTURE_CATEGORY_OTHER);
+    static TextureHandle addRef(TextureHandle handle);
+    // Drops one reference and clears the handle. A texture without references stays
+    // resident as cache until the memory budget needs the space back.
+    static void release(TextureHandle& handle);
+    // Textures created outside the manager (render targets such as the baked map) that
+    // still count toward the stats and the budget. They cannot be reloaded from an
+    // asset, so they are never evicted; the owner reports them when created and destroyed.
+    static void trackExternal(TextureCategory category, size_t bytes, bool created);
+
+    // 0 means unlimited. Only unreferenced textures are ever evicted.
+    static void setMemoryBudget(size_t bytes);
+    static size_t getMemoryBudget() { return memoryBudget; }
+    static void purgeUnreferenced();
+
+    static SDL_Texture* get(TextureHandle handle) {
+        if (handle.slot >= slots.size()) return nullptr;
+        const Slot& slot = slots[handle.slot];
+        return slot.generation == handle.generation ? slot.texture : nullptr;
+    }
+    static int getRefCount(TextureHandle handle);
+    static int getLoadedCount();
+    static TextureStats getStats(TextureCategory category) { return categoryStats[category]; }
+    static TextureStats getTotalStats();
+    static const char* getCategoryName(TextureCategory category);
+    static void printStats();
+
     static void Draw(SDL_Renderer* renderer, SDL_Texture* tex, SDL_Rect src, SDL_Rect dest, SDL_RendererFlip flip = SDL_FLIP_NONE);
     static void cleanUp();
-};
\ No newline at end of file
+
+private:
+    static void freeSlot(int index);
+    static void lruPushBack(int index);
+    static void lruUnlink(int index);
+    static void enforceBudget();
+};
@@ -0,0 +1,210 @@
+#include "UiLayer.h"
+#include "Constants.h"
+#include <cstdio>
+
+const int TextCache::CAPACITY;
+const int UiLayer::NO_ACTION;
+
+static const int FONT_POINTS[UiLayer::FONT_COUNT] = { 24, 48, 60 };
+
+static Uint32 packColor(SDL_Color c) {
+    return static_cast<Uint32>(c.r) << 24 | static_cast<Uint32>(c.g) << 16 | static_cast<Uint32>(c.b) << 8 | c.a;
+}
+
+TextCache::TextCache() :
+    renderer(nullptr),
+    useCounter(0),
+    renders(0)
+{
+    entries.reserve(CAPACITY);
+}
+
+TextCache::~TextCache() {
+    clear();
+}
+
+int TextCache::acquire(TTF_Font* font, SDL_Color color, const std::string& text) {
+    if (!renderer || !font) return -1;
+    Uint32 key = packColor(color);
+    int victim = -1;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        Entry& entry = entries[i];
+        if (entry.font == font && entry.color == key && entry.text == text) {
+            ++entry.holders;
+            entry.lastUsed = ++useCounter;
+            return static_cast<int>(i);
+        }
+        if (entry.holders == 0 && (victim < 0 || entry.lastUsed < entries[victim].lastUsed)) {
+            victim = static_cast<int>(i);
+        }
+    }
+
+    const bool hasRoom = static_cast<int>(entries.size()) < CAPACITY;
+    if (!hasRoom && victim < 0) {
+        printf("Text cache full; cannot render '%s'\n", text.c_str());
+        return -1;
+    }
+
+    // Render before touching the table, so a failure leaves no empty entry behind
+    // and does not evict a label that is still good.
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
+    if (!surface) {
+        printf("Failed to render text '%s'! TTF Error: %s\n", text.c_str(), TTF_GetError());
+        return -1;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        printf("Failed to create texture for text '%s'! SDL Error: %s\n", text.c_str(), SDL_GetError());
+        return -1;
+    }
+
+    int slot;
+    if (hasRoom) {
+        slot = static_cast<int>(entries.size());
+        entries.push_back(Entry());
+    }
+    else {
+        slot = victim;
+        if (entries[slot].texture) SDL_DestroyTexture(entries[slot].texture);
+        entries[slot] = Entry();
+    }
+    Entry& entry = entries[slot];
+    entry.font = font;
+    entry.color = key;
+    entry.text = text;
+    entry.texture = texture;
+    entry.holders = 1;
+    entry.lastUsed = ++useCounter;
+    ++renders;
+    return slot;
+}
+
+void TextCache::release(int entry) {
+    if (entry >= 0 && entries[entry].holders > 0) --entries[entry].holders;
+}
+
+void TextCache::clear() {
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].texture) SDL_DestroyTexture(entries[i].texture);
+    }
+    entries.clear();
+}
+
+UiLayer::UiLayer() :
+    renderer(nullptr)
+{
+    for (int f = 0; f < FONT_COUNT; ++f) fonts[f] = nullptr;
+}
+
+UiLayer::~UiLayer() {
+    shutdown();
+}
+
+bool UiLayer::init(SDL_Renderer* target, const char* fontPath) {
+    renderer = target;
+    cache.setRenderer(target);
+    for (int f = 0; f < FONT_COUNT; ++f) {
+        fonts[f] = TTF_OpenFont(fontPath, FONT_POINTS[f]);
+        if (!fonts[f]) {
+            printf("Failed to load font %s at %d pt! TTF Error: %s\n", fontPath, FONT_POINTS[f], TTF_GetError());
+            shutdown();
+            return false;
+        }
+    }
+    return true;
+}
+
+void UiLayer::shutdown() {
+    widgets.clear();
+    cache.clear();
+    for (int f = 0; f < FONT_COUNT; ++f) {
+        if (fonts[f]) TTF_CloseFont(fonts[f]);
+        fonts[f] = nullptr;
+    }
+    renderer = nullptr;
+}
+
+int UiLayer::add(Screen screen, FontSize font, SDL_Color color, const std::string& text,
+                 Place place, int x, int y, int below, int action) {
+    Widget widget;
+    widget.screen = screen;
+    widget.font = font;
+    widget.color = color;
+    widget.text = text;
+    widget.place = place;
+    widget.x = x;
+    widget.y = y;
+    widget.below = below;
+    widget.action = action;
+    widget.visible = true;
+    widget.dirty = true;
+    widget.entry = -1;
+    widget.rect = SDL_Rect();
+    measure(widget);
+    widgets.push_back(widget);
+    layout();
+    return static_cast<int>(widgets.size()) - 1;
+}
+
+void UiLayer::setText(int id, const std::string& text) {
+    Widget& widget = widgets[id];
+    if (widget.text == text) return;
+    widget.text = text;
+    widget.dirty = true;
+    int oldW = widget.rect.w, oldH = widget.rect.h;
+    measure(widget);
+    if (widget.rect.w != oldW || widget.rect.h != oldH) layout();
+}
+
+void UiLayer::measure(Widget& widget) {
+    int w = 0, h = 0;
+    if (fonts[widget.font]) TTF_SizeText(fonts[widget.font], widget.text.c_str(), &w, &h);
+    widget.rect.w = w;
+    widget.rect.h = h;
+}
+
+void UiLayer::layout() {
+    // Widgets only ever sit below ones declared before them, so one pass in order settles everything.
+    for (size_t i = 0; i < widgets.size(); ++i) {
+        Widget& widget = widgets[i];
+        SDL_Rect& r = widget.rect;
+        r.x = widget.place == PLACE_TOP_LEFT ? widget.x : WINDOW_WIDTH / 2 - r.w / 2;
+        switch (widget.place) {
+        case PLACE_TOP_LEFT:   r.y = widget.y; break;
+        case PLACE_CENTER:     r.y = WINDOW_HEIGHT / 2 - r.h / 2 + widget.y; break;
+        case PLACE_CENTER_TOP: r.y = WINDOW_HEIGHT / 2 + widget.y; break;
+        case PLACE_BELOW: {
+            const SDL_Rect& above = widgets[widget.below].rect;
+            r.y = above.y + above.h + widget.y;
+            break;
+        }
+        }
+    }
+}
+
+int UiLayer::hitTest(Screen screen, int x, int y) const {
+    for (size_t i = widgets.size(); i-- > 0;) {
+        const Widget& widget = widgets[i];
+        if (widget.screen != screen || !widget.visible || widget.action == NO_ACTION) continue;
+        const SDL_Rect& r = widget.rect;
+        if (x >= r.x && x <= r.x + r.w && y >= r.y && y <= r.y + r.h) return widget.action;
+    }
+    return NO_ACTION;
+}
+
+void UiLayer::render(Screen screen) {
+    for (size_t i = 0; i < widgets.size(); ++i) {
+        Widget& widget = widgets[i];
+        if (widget.screen != screen || !widget.visible) continue;
+        if (widget.dirty) {
+            cache.release(widget.entry);
+            widget.entry = cache.acquire(fonts[widget.font], widget.color, widget.text);
+            // Stays dirty when the label could not be rendered, so the next frame retries.
+            widget.dirty = widget.entry < 0;
+        }
+        if (widget.entry < 0) continue;
+        SDL_Texture* texture = cache.getTexture(widget.entry);
+        if (texture) SDL_RenderCopy(renderer, texture, nullptr, &widget.rect);
+    }
+}
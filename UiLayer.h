@@ -0,0 +1,115 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <vector>
+
+// Rasterized labels keyed by font, colour and text. A label is rendered the first
+// time it is asked for and shared by every widget showing it; entries nobody holds
+// any more are evicted, oldest first, once the cache is full.
+class TextCache {
+public:
+    static const int CAPACITY = 64;
+
+    TextCache();
+    ~TextCache();
+
+    void setRenderer(SDL_Renderer* target) { renderer = target; }
+    // Returns an entry index with one more holder, or -1 if the text could not be rendered.
+    int acquire(TTF_Font* font, SDL_Color color, const std::string& text);
+    void release(int entry);
+    SDL_Texture* getTexture(int entry) const { return entries[entry].texture; }
+    void clear();
+
+    int getRenderCount() const { return renders; }
+
+private:
+    struct Entry {
+        TTF_Font* font = nullptr;
+        Uint32 color = 0;
+        std::string text;
+        SDL_Texture* texture = nullptr;
+        int holders = 0;
+        Uint32 lastUsed = 0;
+    };
+
+    SDL_Renderer* renderer;
+    std::vector<Entry> entries;
+    Uint32 useCounter;
+    int renders;
+};
+
+// Retained text widgets for the menus and the HUD. Each screen declares its
+// widgets once; layout runs on measured text sizes (no rendering) and only again
+// when a label's text changes, a widget fetches its texture from the TextCache
+// only when it is dirty, and clicks resolve through one table of widget actions.
+class UiLayer {
+public:
+    enum Screen : Uint8 {
+        SCREEN_MENU,
+        SCREEN_SETTINGS,
+        SCREEN_HUD,
+        SCREEN_GAME_OVER,
+        SCREEN_PAUSED,
+        SCREEN_COUNT
+    };
+
+    enum FontSize : Uint8 {
+        FONT_SMALL,     // 24 pt: HUD and small buttons
+        FONT_MENU,      // 48 pt: menu buttons
+        FONT_TITLE,     // 60 pt: screen titles
+        FONT_COUNT
+    };
+
+    // Where a widget sits. Everything but PLACE_TOP_LEFT is centred horizontally.
+    enum Place : Uint8 {
+        PLACE_TOP_LEFT,     // x, y from the window's top left
+        PLACE_CENTER,       // middle of the window, moved down by y
+        PLACE_CENTER_TOP,   // top edge at the window's middle line plus y
+        PLACE_BELOW         // top edge y below the bottom of another widget
+    };
+
+    static const int NO_ACTION = -1;
+
+    UiLayer();
+    ~UiLayer();
+
+    bool init(SDL_Renderer* renderer, const char* fontPath);
+    void shutdown();
+
+    // Declares a widget; action, when not NO_ACTION, is what hitTest reports for it.
+    int add(Screen screen, FontSize font, SDL_Color color, const std::string& text,
+            Place place, int x, int y, int below = -1, int action = NO_ACTION);
+    // Changing the text marks the widget dirty and re-runs layout if its size changed.
+    void setText(int widget, const std::string& text);
+    void setVisible(int widget, bool visible) { widgets[widget].visible = visible; }
+    const SDL_Rect& getRect(int widget) const { return widgets[widget].rect; }
+
+    // Action of the topmost visible widget of 'screen' under (x, y), or NO_ACTION.
+    int hitTest(Screen screen, int x, int y) const;
+    void render(Screen screen);
+
+private:
+    struct Widget {
+        Screen screen;
+        FontSize font;
+        SDL_Color color;
+        std::string text;
+        Place place;
+        int x, y;
+        int below;
+        int action;
+        bool visible;
+        bool dirty;
+        int entry;          // TextCache entry while not dirty, -1 before the first draw
+        SDL_Rect rect;
+    };
+
+    void measure(Widget& widget);
+    void layout();
+
+    SDL_Renderer* renderer;
+    TTF_Font* fonts[FONT_COUNT];
+    TextCache cache;
+    std::vector<Widget> widgets;
+};
@@ -0,0 +1,201 @@
+#include "World.h"
+#include "CharacterSkins.h"
+#include "TextureManager.h"
+#include <cmath>
+
+World::World() {
+}
+
+void World::reserve(int count) {
+    const size_t n = static_cast<size_t>(count);
+    slots.reserve(n);
+    freeSlots.reserve(n);
+    denseSlot.reserve(n);
+    mask.reserve(n);
+    posX.reserve(n);
+    posY.reserve(n);
+    boxW.reserve(n);
+    boxH.reserve(n);
+    boxes.reserve(n);
+    anims.reserve(n);
+    spriteScale.reserve(n);
+    spriteLayer.reserve(n);
+    spriteFlip.reserve(n);
+}
+
+EntityId World::create(Uint8 components) {
+    Uint16 slotIndex;
+    if (!freeSlots.empty()) {
+        slotIndex = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slotIndex = static_cast<Uint16>(slots.size());
+        slots.push_back(Slot());
+    }
+    Slot& slot = slots[slotIndex];
+    slot.dense = static_cast<int>(mask.size());
+
+    denseSlot.push_back(slotIndex);
+    mask.push_back(components);
+    posX.push_back(0.0f);
+    posY.push_back(0.0f);
+    boxW.push_back(0);
+    boxH.push_back(0);
+    boxes.push_back(SDL_Rect());
+    anims.push_back(AnimState());
+    spriteScale.push_back(1);
+    spriteLayer.push_back(RENDER_LAYER_ITEMS);
+    spriteFlip.push_back(SDL_FLIP_NONE);
+
+    EntityId id;
+    id.slot = slotIndex;
+    id.generation = slot.generation;
+    return id;
+}
+
+void World::destroy(EntityId& id) {
+    int i = indexOf(id);
+    id = EntityId();
+    if (i < 0) return;
+
+    // Move the last entity into the hole so the columns stay packed.
+    int last = static_cast<int>(mask.size()) - 1;
+    Uint16 slotIndex = denseSlot[i];
+    if (i != last) {
+        denseSlot[i] = denseSlot[last];
+        mask[i] = mask[last];
+        posX[i] = posX[last];
+        posY[i] = posY[last];
+        boxW[i] = boxW[last];
+        boxH[i] = boxH[last];
+        boxes[i] = boxes[last];
+        anims[i] = anims[last];
+        spriteScale[i] = spriteScale[last];
+        spriteLayer[i] = spriteLayer[last];
+        spriteFlip[i] = spriteFlip[last];
+        slots[denseSlot[i]].dense = i;
+    }
+    denseSlot.pop_back();
+    mask.pop_back();
+    posX.pop_back();
+    posY.pop_back();
+    boxW.pop_back();
+    boxH.pop_back();
+    boxes.pop_back();
+    anims.pop_back();
+    spriteScale.pop_back();
+    spriteLayer.pop_back();
+    spriteFlip.pop_back();
+
+    Slot& slot = slots[slotIndex];
+    slot.dense = -1;
+    // Bump the generation so any handle still pointing here goes stale.
+    if (++slot.generation == 0) slot.generation = 1;
+    freeSlots.push_back(slotIndex);
+}
+
+EntityId World::getEntityAt(int index) const {
+    EntityId id;
+    id.slot = denseSlot[index];
+    id.generation = slots[id.slot].generation;
+    return id;
+}
+
+void World::updateBox(int i) {
+    boxes[i].x = static_cast<int>(std::floor(posX[i]));
+    boxes[i].y = static_cast<int>(std::floor(posY[i]));
+    boxes[i].w = boxW[i];
+    boxes[i].h = boxH[i];
+}
+
+void World::setPosition(EntityId id, float x, float y) {
+    int i = indexOf(id);
+    SDL_assert(i >= 0);
+    if (i < 0) return;
+    posX[i] = x;
+    posY[i] = y;
+    updateBox(i);
+}
+
+void World::setBoxSize(EntityId id, int w, int h) {
+    int i = indexOf(id);
+    SDL_assert(i >= 0);
+    if (i < 0) return;
+    boxW[i] = static_cast<Sint16>(w);
+    boxH[i] = static_cast<Sint16>(h);
+    updateBox(i);
+}
+
+const SDL_Rect& World::getBox(EntityId id) const {
+    static const SDL_Rect none = { 0, 0, 0, 0 };
+    int i = indexOf(id);
+    SDL_assert(i >= 0);
+    return i >= 0 ? boxes[i] : none;
+}
+
+void World::playClip(EntityId id, AnimClipId clip) {
+    int i = indexOf(id);
+    SDL_assert(i >= 0);
+    if (i < 0) return;
+    AnimationLibrary::play(anims[i], clip);
+}
+
+void World::setClipFrame(EntityId id, int frame) {
+    int i = indexOf(id);
+    SDL_assert(i >= 0);
+    if (i < 0) return;
+    const AnimClip& clip = AnimationLibrary::get(anims[i].clip);
+    anims[i].frame = static_cast<Uint16>(clip.frames > 0 ? frame % clip.frames : 0);
+}
+
+Uint8 World::getClip(EntityId id) const {
+    int i = indexOf(id);
+    SDL_assert(i >= 0);
+    return i >= 0 ? anims[i].clip : 0;
+}
+
+void World::setSprite(EntityId id, int scale, RenderLayer layer) {
+    int i = indexOf(id);
+    SDL_assert(i >= 0);
+    if (i < 0) return;
+    spriteScale[i] = static_cast<Uint8>(scale);
+    spriteLayer[i] = layer;
+}
+
+void World::setFlip(EntityId id, SDL_RendererFlip flip) {
+    int i = indexOf(id);
+    SDL_assert(i >= 0);
+    if (i < 0) return;
+    spriteFlip[i] = static_cast<Uint8>(flip);
+}
+
+
+void World::updateAnimations(Uint32 dtMs) {
+    const int count = static_cast<int>(mask.size());
+    for (int i = 0; i < count; ++i) {
+        if (mask[i] & COMPONENT_ANIMATION) AnimationLibrary::advance(anims[i], dtMs);
+    }
+}
+
+void World::render(SDL_Renderer* renderer) const {
+    if (!renderer) return;
+    const Uint8 wanted = COMPONENT_TRANSFORM | COMPONENT_ANIMATION | COMPONENT_SPRITE;
+    const int count = static_cast<int>(mask.size());
+    for (int layer = 0; layer < RENDER_LAYER_COUNT; ++layer) {
+        for (int i = 0; i < count; ++i) {
+            if ((mask[i] & wanted) != wanted || spriteLayer[i] != layer) continue;
+            const AnimState& anim = anims[i];
+            // The selected character skin replaces the sheet of player clips.
+            SDL_Texture* texture = CharacterSkins::sheet(anim.clip);
+            if (!texture) texture = TextureManager::get(AnimationLibrary::get(anim.clip).texture);
+            if (!texture) continue;
+
+            const AnimClip& clip = AnimationLibrary::get(anim.clip);
+            SDL_Rect src = AnimationLibrary::frameRect(anim);
+            SDL_Rect dst = { static_cast<int>(std::floor(posX[i])), static_cast<int>(std::floor(posY[i])),
+                             clip.frameW * spriteScale[i], clip.frameH * spriteScale[i] };
+            SDL_RenderCopyEx(renderer, texture, &src, &dst, 0, nullptr, static_cast<SDL_RendererFlip>(spriteFlip[i]));
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "Animation.h"
+
+// Generation-checked entity reference, same scheme as TextureHandle: a handle
+// whose entity was destroyed (or whose slot was reused) is no longer alive.
+struct EntityId {
+    Uint16 slot = 0;
+    Uint16 generation = 0;  // 0 is never a live generation
+
+    bool isValid() const { return generation != 0; }
+};
+
+// Entity storage in structure-of-arrays layout. Live entities are packed at the
+// front of every column (destroy swaps the last one into the hole), and each
+// entity carries a mask of the components it uses. Systems walk the columns
+// front to back and skip entities whose mask does not match.
+class World {
+public:
+    enum Component : Uint8 {
+        COMPONENT_TRANSFORM = 1 << 0,  // position in pixels
+        COMPONENT_AABB      = 1 << 1,  // collision box at the position
+        COMPONENT_ANIMATION = 1 << 2,  // clip playback, stepped by updateAnimations()
+        COMPONENT_SPRITE    = 1 << 3   // drawn by render() from the current clip frame
+    };
+
+    // Sprites draw one layer at a time, in this order.
+    enum RenderLayer : Uint8 {
+        RENDER_LAYER_ITEMS,
+        RENDER_LAYER_ACTORS,
+        RENDER_LAYER_COUNT
+    };
+
+    World();
+
+    // Makes room for 'count' entities in every column, so creating up to that many
+    // never allocates.
+    void reserve(int count);
+    EntityId create(Uint8 components);
+    // Clears the handle.
+    void destroy(EntityId& id);
+    int getEntityCount() const { return static_cast<int>(mask.size()); }
+
+    // Component access by handle. The entity should be alive and have the component;
+    // a stale handle asserts, then setters ignore it and getters read zero.
+    void setPosition(EntityId id, float x, float y);
+    void setBoxSize(EntityId id, int w, int h);
+    const SDL_Rect& getBox(EntityId id) const;
+    // Switches clip and restarts it; playing the clip already running changes nothing.
+    void playClip(EntityId id, AnimClipId clip);
+    // Jumps the running clip to 'frame', wrapped to the clip's length.
+    void setClipFrame(EntityId id, int frame);
+    Uint8 getClip(EntityId id) const;
+    void setSprite(EntityId id, int scale, RenderLayer layer);
+    void setFlip(EntityId id, SDL_RendererFlip flip);
+
+    // Dense views for systems outside World; index i is the i-th live entity and
+    // stays valid until the next create() or destroy().
+    const SDL_Rect* getBoxes() const { return boxes.data(); }
+    EntityId getEntityAt(int index) const;
+
+    // Systems. Movement is not one: the player integrates its own body against the
+    // map and pushes the result in with setPosition().
+    void updateAnimations(Uint32 dtMs);
+    void render(SDL_Renderer* renderer) const;
+
+private:
+    struct Slot {
+        int dense = -1;         // index into the columns, -1 when free
+        Uint16 generation = 1;
+    };
+
+    int indexOf(EntityId id) const {
+        if (id.slot >= slots.size()) return -1;
+        const Slot& slot = slots[id.slot];
+        return slot.generation == id.generation ? slot.dense : -1;
+    }
+    void updateBox(int i);
+
+    std::vector<Slot> slots;
+    std::vector<Uint16> freeSlots;
+
+    // Columns, all the same length; denseSlot maps a column index back to its slot.
+    std::vector<Uint16> denseSlot;
+    std::vector<Uint8> mask;
+    std::vector<float> posX, posY;
+    std::vector<Sint16> boxW, boxH;
+    std::vector<SDL_Rect> boxes;
+    std::vector<AnimState> anims;
+    std::vector<Uint8> spriteScale;
+    std::vector<Uint8> spriteLayer;
+    std::vector<Uint8> spriteFlip;
+};
@@ -1,10 +1,117 @@
 #include "Game.h"
 #include "Constants.h"
+#include "TextureManager.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
 
 int main(int argc, char* argv[]) {
     Game game;
+
+    // --capture-png <prefix> | --capture-y4m <file> [--capture-every N]
+    int captureEvery = 1;
+    // --deterministic [--checksum-log <file>]
+    bool deterministic = false;
+    std::string checksumLog;
+    // --bots N [--bot-threads T] [--bots-hidden]
+    int botCount = 0;
+    int botThreads = 0;
+    bool botRender = true;
+    // --autoplay [--soak-log <file>] [--soak-interval <seconds>]
+    bool autoplay = false;
+    std::string soakLog;
+    int soakIntervalSeconds = 60;
+    // --jump-buffer-ms N --coyote-ms N (0 turns either off)
+    int jumpBufferMs = 100;
+    int coyoteMs = 80;
+    // --latency-stats --late-latch
+    bool latencyStats = false;
+    bool lateLatch = false;
+    // --fruits N
+    int fruitCount = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--capture-every") == 0 && i + 1 < argc) {
+            captureEvery = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--texture-budget-mb") == 0 && i + 1 < argc) {
+            const char* value = argv[++i];
+            char* end = nullptr;
+            long megabytes = strtol(value, &end, 10);
+            if (end == value || *end != '\0' || megabytes <= 0) {
+                printf("Ignoring --texture-budget-mb '%s': expected a positive number of megabytes\n", value);
+            }
+            else {
+                TextureManager::setMemoryBudget(static_cast<size_t>(megabytes) * 1024 * 1024);
+            }
+        }
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            game.setLevelPath(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            game.setSeed(strtoull(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "--deterministic") == 0) {
+            deterministic = true;
+        }
+        else if (strcmp(argv[i], "--checksum-log") == 0 && i + 1 < argc) {
+            checksumLog = argv[++i];
+        }
+        else if (strcmp(argv[i], "--bots") == 0 && i + 1 < argc) {
+            botCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--bot-threads") == 0 && i + 1 < argc) {
+            botThreads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--bots-hidden") == 0) {
+            botRender = false;
+        }
+        else if (strcmp(argv[i], "--autoplay") == 0) {
+            autoplay = true;
+        }
+        else if (strcmp(argv[i], "--soak-log") == 0 && i + 1 < argc) {
+            soakLog = argv[++i];
+        }
+        else if (strcmp(argv[i], "--soak-interval") == 0 && i + 1 < argc) {
+            soakIntervalSeconds = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--jump-buffer-ms") == 0 && i + 1 < argc) {
+            jumpBufferMs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--coyote-ms") == 0 && i + 1 < argc) {
+            coyoteMs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--latency-stats") == 0) {
+            latencyStats = true;
+        }
+        else if (strcmp(argv[i], "--late-latch") == 0) {
+            lateLatch = true;
+        }
+        else if (strcmp(argv[i], "--fruits") == 0 && i + 1 < argc) {
+            fruitCount = atoi(argv[++i]);
+        }
+    }
+    game.setDeterministic(deterministic, checksumLog);
+    game.setBotSwarm(botCount, botThreads, botRender);
+    game.setAutoplay(autoplay);
+    game.setJumpAssist(jumpBufferMs > 0 ? jumpBufferMs : 0, coyoteMs > 0 ? coyoteMs : 0);
+    game.setLatencyStats(latencyStats);
+    game.setLateLatch(lateLatch);
+    game.setFruitCount(fruitCount);
+    if (!soakLog.empty()) {
+        game.setSoakLog(soakLog, static_cast<Uint32>(soakIntervalSeconds > 0 ? soakIntervalSeconds : 60) * 1000);
+    }
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--capture-png") == 0 && i + 1 < argc) {
+            game.enableFrameCapture(FrameCapture::Format::PNG, argv[++i], captureEvery);
+        }
+        else if (strcmp(argv[i], "--capture-y4m") == 0 && i + 1 < argc) {
+            game.enableFrameCapture(FrameCapture::Format::Y4M, argv[++i], captureEvery);
+        }
+    }
+
     game.init("SDL2 Game", WINDOW_WIDTH, WINDOW_HEIGHT);
     game.run();
 
     return 0;
-}
\ No newline at end of file
+}
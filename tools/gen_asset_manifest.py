@@ -0,0 +1,169 @@
+"""Generate AssetManifest.h from the files under assets/.
+
+    python tools/gen_asset_manifest.py          regenerate AssetManifest.h
+    python tools/gen_asset_manifest.py --check  fail if AssetManifest.h is stale or if any
+                                                "assets/..." path referenced from code or
+                                                data files is missing or mis-cased on disk
+
+The --check form runs as a pre-build step of SDLGame.vcxproj.
+"""
+import os
+import re
+import struct
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+ASSET_DIR = 'assets'
+OUTPUT = 'AssetManifest.h'
+# Files whose "assets/..." string references are validated against the disk.
+REFERENCE_SOURCES = ('.cpp', '.h', '.txt')
+FRAME_SIZE = re.compile(r'\(?(\d+)x(\d+)\)?')
+PATH_LITERAL = re.compile(r'assets/[^"\r\n]*\.[A-Za-z0-9]+')
+# Caches the game writes next to their source files at runtime; never assets.
+RUNTIME_CACHES = ('.reach',)
+
+
+def list_assets():
+    assets = []
+    for dirpath, dirnames, filenames in os.walk(os.path.join(ROOT, ASSET_DIR)):
+        dirnames.sort()
+        for name in sorted(filenames):
+            if name.endswith(RUNTIME_CACHES):
+                continue
+            full = os.path.join(dirpath, name)
+            assets.append(os.path.relpath(full, ROOT).replace(os.sep, '/'))
+    assets.sort()
+    return assets
+
+
+def png_size(path):
+    with open(os.path.join(ROOT, path), 'rb') as f:
+        header = f.read(24)
+    if header[:8] != b'\x89PNG\r\n\x1a\n':
+        raise SystemExit('error: %s is not a PNG file' % path)
+    return struct.unpack('>II', header[16:24])
+
+
+def identifier(path):
+    stem = os.path.splitext(path[len(ASSET_DIR) + 1:])[0]
+    stem = FRAME_SIZE.sub('', stem)
+    name = re.sub(r'[^A-Za-z0-9]+', '_', stem).strip('_').upper()
+    return 'ASSET_' + name
+
+
+def describe(path):
+    width = height = frame_w = frame_h = frames = 0
+    if path.lower().endswith('.png'):
+        width, height = png_size(path)
+        match = FRAME_SIZE.search(os.path.basename(path))
+        frame_w, frame_h = (int(match.group(1)), int(match.group(2))) if match else (width, height)
+        # Atlases such as "Sand Mud Ice (16x6)" are not strips; count whole cells only.
+        frames = (width // frame_w) * (height // frame_h)
+    return width, height, frame_w, frame_h, frames
+
+
+def generate():
+    assets = list_assets()
+    names = {}
+    rows = []
+    for path in assets:
+        name = identifier(path)
+        if name in names:
+            raise SystemExit('error: %s and %s both map to %s' % (names[name], path, name))
+        names[name] = path
+        rows.append((name, path) + describe(path))
+
+    out = []
+    out.append('// Generated by tools/gen_asset_manifest.py from assets/. Do not edit by hand.')
+    out.append('#pragma once')
+    out.append('#include <SDL.h>')
+    out.append('#include <cstring>')
+    out.append('')
+    out.append('typedef Uint16 AssetId;')
+    out.append('const AssetId INVALID_ASSET = 0xFFFF;')
+    out.append('')
+    out.append('struct AssetInfo {')
+    out.append('    const char* path;')
+    out.append('    Uint16 width, height;    // image size in pixels, 0 for non-images')
+    out.append('    Uint16 frameW, frameH;   // from a "(WxH)" / "WxH" file name, else the whole image')
+    out.append('    Uint16 frames;')
+    out.append('};')
+    out.append('')
+    out.append('enum AssetName : AssetId {')
+    for row in rows:
+        out.append('    %s,' % row[0])
+    out.append('    ASSET_COUNT')
+    out.append('};')
+    out.append('')
+    out.append('// Sorted by path so findAsset() can binary search.')
+    out.append('constexpr AssetInfo ASSET_MANIFEST[ASSET_COUNT] = {')
+    for name, path, w, h, fw, fh, frames in rows:
+        out.append('    { "%s", %d, %d, %d, %d, %d },' % (path, w, h, fw, fh, frames))
+    out.append('};')
+    out.append('')
+    out.append('// Exact, case-sensitive lookup for paths that come from data files.')
+    out.append('inline AssetId findAsset(const char* path) {')
+    out.append('    int lo = 0, hi = ASSET_COUNT - 1;')
+    out.append('    while (lo <= hi) {')
+    out.append('        int mid = (lo + hi) / 2;')
+    out.append('        int cmp = strcmp(ASSET_MANIFEST[mid].path, path);')
+    out.append('        if (cmp == 0) return static_cast<AssetId>(mid);')
+    out.append('        if (cmp < 0) lo = mid + 1;')
+    out.append('        else hi = mid - 1;')
+    out.append('    }')
+    out.append('    return INVALID_ASSET;')
+    out.append('}')
+    return '\n'.join(out) + '\n', set(assets)
+
+
+def check_references(assets):
+    lower = {a.lower(): a for a in assets}
+    errors = []
+    for dirpath, dirnames, filenames in os.walk(ROOT):
+        rel = os.path.relpath(dirpath, ROOT).replace(os.sep, '/')
+        if rel != '.' and rel.split('/')[0] not in (ASSET_DIR,):
+            dirnames[:] = []
+            continue
+        for name in filenames:
+            if not name.endswith(REFERENCE_SOURCES) or name == OUTPUT:
+                continue
+            path = os.path.join(dirpath, name)
+            with open(path, encoding='utf-8-sig', errors='replace') as f:
+                for lineno, line in enumerate(f, 1):
+                    for ref in PATH_LITERAL.findall(line):
+                        ref = ref.strip()
+                        if ref in assets:
+                            continue
+                        where = '%s:%d' % (os.path.relpath(path, ROOT), lineno)
+                        if ref.lower() in lower:
+                            errors.append('%s: "%s" is mis-cased, the file is "%s"' % (where, ref, lower[ref.lower()]))
+                        else:
+                            errors.append('%s: "%s" does not exist' % (where, ref))
+    return errors
+
+
+def main():
+    text, assets = generate()
+    target = os.path.join(ROOT, OUTPUT)
+    if '--check' in sys.argv[1:]:
+        errors = check_references(assets)
+        try:
+            with open(target, encoding='utf-8') as f:
+                current = f.read().replace('\r\n', '\n')
+        except IOError:
+            current = ''
+        if current != text:
+            errors.append('%s is out of date with assets/; run tools/gen_asset_manifest.py' % OUTPUT)
+        for error in errors:
+            print('error: ' + error)
+        if errors:
+            sys.exit(1)
+        print('Asset manifest OK (%d assets).' % len(assets))
+        return
+    with open(target, 'w', encoding='utf-8', newline='\r\n') as f:
+        f.write(text)
+    print('Wrote %s (%d assets).' % (OUTPUT, len(assets)))
+
+
+if __name__ == '__main__':
+    main()
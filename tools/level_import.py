@@ -0,0 +1,233 @@
+"""Build a binary level (see LevelFormat.h) from a text or Tiled JSON source.
+
+    python tools/level_import.py levels/level1.txt assets/levels/level1.lvl
+    python tools/level_import.py mylevel.tmj assets/levels/mylevel.lvl
+
+Text sources are line based:
+
+    # comment
+    tileset assets/platforms.png        tileset image, as listed in AssetManifest.h
+    tilesize 16 16                      source tile size in pixels
+    tile # 4                            map character -> tileset index ('.' and ' ' are empty)
+    autotile G 6                        map character -> 3x3 terrain block whose top-left tile
+                                        is tileset index 6; edges and corners are picked at load
+    spawn player 100 448                spawn point in pixels (player | collectible)
+    entity Saw 320 256 64 64 0          type x y w h [param]
+    map                                 every following line is one row of tiles
+
+Tiled sources (.json / .tmj) use the first tile layer and the first tileset;
+objects whose class (or type) is player_spawn / collectible_spawn become spawns,
+every other object becomes an entity of that class with its optional "param"
+property. Tileset index 0 is reserved for empty cells.
+"""
+import json
+import os
+import struct
+import sys
+import xml.etree.ElementTree as ElementTree
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+
+MAGIC = 0x4C56454C
+VERSION = 2
+MAX_COLS = 64
+HEADER = struct.Struct('<IHHIHHHH64sIIIIII')
+SPAWN = struct.Struct('<HHii')
+ENTITY = struct.Struct('<16siiiii')
+SPAWN_KINDS = {'player': 0, 'collectible': 1}
+AUTOTILE = 0x8000
+TILED_FLIP_BITS = 0xE0000000
+
+
+class Level(object):
+    def __init__(self):
+        self.tileset = None
+        self.tile_w = self.tile_h = 16
+        self.rows = []        # list of lists of tileset indices
+        self.spawns = []      # (kind, x, y)
+        self.entities = []    # (type, x, y, w, h, param)
+
+
+def fail(source, message, lineno=None):
+    where = '%s:%d' % (source, lineno) if lineno else source
+    raise SystemExit('error: %s: %s' % (where, message))
+
+
+def parse_text(path):
+    level = Level()
+    legend = {}
+    in_map = False
+    with open(path, encoding='utf-8-sig') as f:
+        for lineno, raw in enumerate(f, 1):
+            line = raw.rstrip('\r\n')
+            if in_map:
+                if not line.strip():
+                    continue
+                row = []
+                for ch in line:
+                    if ch in '. ':
+                        row.append(0)
+                    elif ch in legend:
+                        row.append(legend[ch])
+                    else:
+                        fail(path, 'map character %r has no "tile" entry' % ch, lineno)
+                level.rows.append(row)
+                continue
+
+            words = line.split()
+            if not words or words[0].startswith('#'):
+                continue
+            key, args = words[0], words[1:]
+            try:
+                if key == 'tileset':
+                    level.tileset = line.split(None, 1)[1].strip()
+                elif key == 'tilesize':
+                    level.tile_w, level.tile_h = int(args[0]), int(args[1])
+                elif key in ('tile', 'autotile'):
+                    if len(args[0]) != 1 or args[0] in '. ':
+                        fail(path, 'tile characters must be a single non-empty character', lineno)
+                    index = int(args[1])
+                    if not 0 < index < AUTOTILE:
+                        fail(path, 'tileset index %d is out of range' % index, lineno)
+                    legend[args[0]] = index | (AUTOTILE if key == 'autotile' else 0)
+                elif key == 'spawn':
+                    if args[0] not in SPAWN_KINDS:
+                        fail(path, 'unknown spawn kind %r' % args[0], lineno)
+                    level.spawns.append((SPAWN_KINDS[args[0]], int(args[1]), int(args[2])))
+                elif key == 'entity':
+                    param = int(args[5]) if len(args) > 5 else 0
+                    level.entities.append((args[0], int(args[1]), int(args[2]), int(args[3]), int(args[4]), param))
+                elif key == 'map':
+                    in_map = True
+                else:
+                    fail(path, 'unknown directive %r' % key, lineno)
+            except (IndexError, ValueError):
+                fail(path, 'malformed %r line' % key, lineno)
+
+    width = max(len(row) for row in level.rows) if level.rows else 0
+    for row in level.rows:
+        row.extend([0] * (width - len(row)))
+    return level
+
+
+def parse_tiled(path):
+    with open(path, encoding='utf-8') as f:
+        doc = json.load(f)
+    level = Level()
+    level.tile_w, level.tile_h = doc['tilewidth'], doc['tileheight']
+    width, height = doc['width'], doc['height']
+    base = os.path.dirname(os.path.abspath(path))
+
+    if not doc.get('tilesets'):
+        fail(path, 'map has no tileset')
+    tileset = doc['tilesets'][0]
+    first_gid = tileset['firstgid']
+    image = tileset.get('image')
+    if image is None and 'source' in tileset:
+        tsx = os.path.join(base, tileset['source'])
+        element = ElementTree.parse(tsx).getroot().find('image')
+        if element is None:
+            fail(path, 'tileset %s has no image' % tileset['source'])
+        image = element.get('source')
+        base = os.path.dirname(tsx)
+    level.tileset = os.path.relpath(os.path.normpath(os.path.join(base, image)), ROOT).replace(os.sep, '/')
+
+    layers = [layer for layer in doc['layers'] if layer['type'] == 'tilelayer']
+    if not layers:
+        fail(path, 'map has no tile layer')
+    data = layers[0].get('data')
+    if not isinstance(data, list):
+        fail(path, 'only CSV / array tile layers are supported (set Tile Layer Format to CSV)')
+    for r in range(height):
+        row = []
+        for gid in data[r * width:(r + 1) * width]:
+            gid &= ~TILED_FLIP_BITS
+            index = gid - first_gid if gid else 0
+            if gid and index == 0:
+                fail(path, 'tileset index 0 is reserved for empty cells (row %d)' % r)
+            if index >= AUTOTILE:
+                fail(path, 'tileset index %d is out of range (row %d)' % (index, r))
+            row.append(index)
+        level.rows.append(row)
+
+    for layer in doc['layers']:
+        if layer['type'] != 'objectgroup':
+            continue
+        for obj in layer.get('objects', []):
+            kind = obj.get('class') or obj.get('type') or obj.get('name', '')
+            x, y = int(round(obj['x'])), int(round(obj['y']))
+            w, h = int(round(obj.get('width', 0))), int(round(obj.get('height', 0)))
+            if kind.endswith('_spawn') and kind[:-len('_spawn')] in SPAWN_KINDS:
+                level.spawns.append((SPAWN_KINDS[kind[:-len('_spawn')]], x, y))
+                continue
+            param = 0
+            for prop in obj.get('properties', []):
+                if prop.get('name') == 'param':
+                    param = int(prop['value'])
+            level.entities.append((kind, x, y, w, h, param))
+    return level
+
+
+def align(offset, alignment):
+    return (offset + alignment - 1) // alignment * alignment
+
+
+def build(level, source):
+    if not level.tileset:
+        fail(source, 'no tileset given')
+    if not os.path.isfile(os.path.join(ROOT, level.tileset)):
+        fail(source, 'tileset %s does not exist' % level.tileset)
+    tileset = level.tileset.encode('utf-8')
+    if len(tileset) >= 64:
+        fail(source, 'tileset path is longer than 63 bytes')
+    rows = len(level.rows)
+    cols = len(level.rows[0]) if rows else 0
+    if rows == 0 or cols == 0:
+        fail(source, 'level has no tiles')
+    if cols > MAX_COLS:
+        fail(source, 'level is %d columns wide, the limit is %d' % (cols, MAX_COLS))
+
+    tiles = b''.join(struct.pack('<%dH' % cols, *row) for row in level.rows)
+    solid = b''.join(struct.pack('<Q', sum(1 << c for c, tile in enumerate(row) if tile)) for row in level.rows)
+    spawns = b''.join(SPAWN.pack(kind, 0, x, y) for kind, x, y in level.spawns)
+    entities = b''
+    for kind, x, y, w, h, param in level.entities:
+        name = kind.encode('utf-8')
+        if not name or len(name) >= 16:
+            fail(source, 'entity type %r must be 1-15 bytes' % kind)
+        entities += ENTITY.pack(name, x, y, w, h, param)
+
+    tiles_offset = HEADER.size
+    solid_offset = align(tiles_offset + len(tiles), 8)
+    spawn_offset = solid_offset + len(solid)
+    entity_offset = align(spawn_offset + len(spawns), 4)
+    file_size = align(entity_offset + len(entities), 8)
+
+    out = bytearray(file_size)
+    HEADER.pack_into(out, 0, MAGIC, VERSION, HEADER.size, file_size, rows, cols, level.tile_w, level.tile_h,
+                     tileset, tiles_offset, solid_offset, spawn_offset, len(level.spawns),
+                     entity_offset, len(level.entities))
+    out[tiles_offset:tiles_offset + len(tiles)] = tiles
+    out[solid_offset:solid_offset + len(solid)] = solid
+    out[spawn_offset:spawn_offset + len(spawns)] = spawns
+    out[entity_offset:entity_offset + len(entities)] = entities
+    return bytes(out)
+
+
+def main():
+    if len(sys.argv) != 3:
+        raise SystemExit(__doc__)
+    source, target = sys.argv[1], sys.argv[2]
+    if source.lower().endswith(('.json', '.tmj')):
+        level = parse_tiled(source)
+    else:
+        level = parse_text(source)
+    data = build(level, source)
+    with open(target, 'wb') as f:
+        f.write(data)
+    print('Wrote %s (%dx%d tiles, %d spawns, %d entities, %d bytes).' % (
+        target, len(level.rows[0]), len(level.rows), len(level.spawns), len(level.entities), len(data)))
+
+
+if __name__ == '__main__':
+    main()